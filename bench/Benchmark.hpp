@@ -0,0 +1,142 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+namespace fastsir
+{//start of namespace fastsir
+
+typedef std::map<std::string,std::string> BenchmarkParameters;
+
+//result of a benchmark, repeated a few times
+struct BenchmarkResult
+{
+    std::string group;
+    std::string name;
+    BenchmarkParameters parameters;
+    double operations;
+    double seconds_min;
+    double seconds_median;
+    long peak_rss_kb;
+};
+
+//peak resident set size of the process so far, in kB; since it never
+//decreases, run a single group (--filter) to measure its memory
+inline long peak_rss_kb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss/1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+//time a benchmark; func performs the work and returns the number of
+//operations, and setup (called before each repetition) is not timed
+template <typename Setup, typename Func>
+BenchmarkResult run_benchmark(const std::string& group, const std::string& name,
+        const BenchmarkParameters& parameters, unsigned int repetitions,
+        Setup setup, Func func)
+{
+    std::vector<double> seconds_vector;
+    double operations = 0;
+    for (unsigned int i = 0; i < repetitions; i++)
+    {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        operations = func();
+        auto stop = std::chrono::steady_clock::now();
+        seconds_vector.push_back(std::chrono::duration<double>(stop - start).count());
+    }
+    std::sort(seconds_vector.begin(), seconds_vector.end());
+    return BenchmarkResult({group, name, parameters, operations,
+            seconds_vector.front(), seconds_vector[seconds_vector.size()/2],
+            peak_rss_kb()});
+}
+
+//escape a string for JSON
+inline std::string json_string(const std::string& str)
+{
+    std::string escaped = "\"";
+    for (char c : str)
+    {
+        if (c == '"' or c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+//write the results as a JSON report
+inline void write_json(std::ostream& output, const BenchmarkParameters& context,
+        const std::vector<BenchmarkResult>& result_vector)
+{
+    output.precision(6);
+    output << "{\n  \"context\": {";
+    for (auto it = context.begin(); it != context.end(); ++it)
+    {
+        output << (it == context.begin() ? "" : ", ") << json_string(it->first)
+               << ": " << json_string(it->second);
+    }
+    output << "},\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < result_vector.size(); i++)
+    {
+        const BenchmarkResult& result = result_vector[i];
+        output << "    {\"group\": " << json_string(result.group)
+               << ", \"name\": " << json_string(result.name)
+               << ", \"parameters\": {";
+        for (auto it = result.parameters.begin(); it != result.parameters.end(); ++it)
+        {
+            output << (it == result.parameters.begin() ? "" : ", ")
+                   << json_string(it->first) << ": " << json_string(it->second);
+        }
+        output << "}, \"operations\": " << result.operations
+               << ", \"seconds_min\": " << result.seconds_min
+               << ", \"seconds_median\": " << result.seconds_median
+               << ", \"operations_per_second\": "
+               << (result.seconds_median > 0 ? result.operations/result.seconds_median : 0.)
+               << ", \"peak_rss_kb\": " << result.peak_rss_kb
+               << "}" << (i + 1 < result_vector.size() ? "," : "") << "\n";
+    }
+    output << "  ]\n}\n";
+}
+
+}//end of namespace fastsir
+
+#endif /* BENCHMARK_HPP_ */
@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "GraphGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//key of an undirected edge
+static uint64_t edge_key(Node first, Node second)
+{
+    if (first > second)
+    {
+        swap(first, second);
+    }
+    return (uint64_t(first) << 32) | second;
+}
+
+//G(n,p) random graph; pairs are skipped geometrically (Batagelj and Brandes)
+EdgeList erdos_renyi_graph(size_t number_of_nodes, double mean_degree,
+        sset::RNGType& gen)
+{
+    EdgeList edge_list;
+    double p = mean_degree/(number_of_nodes - 1);
+    if (p <= 0 or p >= 1)
+    {
+        throw invalid_argument("The mean degree must be in (0,n-1)");
+    }
+    uniform_real_distribution<double> random_01(0.,1.);
+    double log_q = log1p(-p);
+    long long v = 1;
+    long long w = -1;
+    long long n = number_of_nodes;
+    while (v < n)
+    {
+        w += 1 + floor(log1p(-random_01(gen))/log_q);
+        while (w >= v and v < n)
+        {
+            w -= v;
+            v += 1;
+        }
+        if (v < n)
+        {
+            edge_list.emplace_back(v, w);
+        }
+    }
+    return edge_list;
+}
+
+//ring lattice with rewiring of the second end of each edge
+EdgeList watts_strogatz_graph(size_t number_of_nodes, unsigned int k, double p,
+        sset::RNGType& gen)
+{
+    if (k % 2 != 0 or k >= number_of_nodes)
+    {
+        throw invalid_argument("k must be even and smaller than n");
+    }
+    uniform_real_distribution<double> random_01(0.,1.);
+    uniform_int_distribution<Node> random_node(0, number_of_nodes - 1);
+    unordered_set<uint64_t> edge_set;
+    EdgeList edge_list;
+    for (Node node = 0; node < number_of_nodes; node++)
+    {
+        for (unsigned int d = 1; d <= k/2; d++)
+        {
+            edge_set.insert(edge_key(node, (node + d) % number_of_nodes));
+        }
+    }
+    for (Node node = 0; node < number_of_nodes; node++)
+    {
+        for (unsigned int d = 1; d <= k/2; d++)
+        {
+            Node neighbor = (node + d) % number_of_nodes;
+            if (random_01(gen) < p)
+            {
+                Node new_neighbor = random_node(gen);
+                if (new_neighbor != node
+                        and edge_set.count(edge_key(node, new_neighbor)) == 0)
+                {
+                    edge_set.erase(edge_key(node, neighbor));
+                    edge_set.insert(edge_key(node, new_neighbor));
+                }
+            }
+        }
+    }
+    for (uint64_t key : edge_set)
+    {
+        edge_list.emplace_back(key >> 32, key & 0xffffffff);
+    }
+    sort(edge_list.begin(), edge_list.end());
+    return edge_list;
+}
+
+//configuration model with a power-law degree distribution
+EdgeList power_law_graph(size_t number_of_nodes, double exponent,
+        unsigned int min_degree, sset::RNGType& gen)
+{
+    unsigned int max_degree = max<unsigned int>(min_degree, sqrt(number_of_nodes));
+    vector<double> cumulative_vector;
+    double cumulative = 0.;
+    for (unsigned int k = min_degree; k <= max_degree; k++)
+    {
+        cumulative += pow(k, -exponent);
+        cumulative_vector.push_back(cumulative);
+    }
+    uniform_real_distribution<double> random_01(0.,1.);
+    vector<Node> stub_vector;
+    for (Node node = 0; node < number_of_nodes; node++)
+    {
+        unsigned int degree = min_degree + (lower_bound(cumulative_vector.begin(),
+                    cumulative_vector.end(), random_01(gen)*cumulative)
+                - cumulative_vector.begin());
+        stub_vector.insert(stub_vector.end(), degree, node);
+    }
+    if (stub_vector.size() % 2 != 0)
+    {
+        stub_vector.push_back(0);
+    }
+    shuffle(stub_vector.begin(), stub_vector.end(), gen);
+
+    unordered_set<uint64_t> edge_set;
+    EdgeList edge_list;
+    for (size_t i = 0; i < stub_vector.size(); i += 2)
+    {
+        Node first = stub_vector[i];
+        Node second = stub_vector[i+1];
+        if (first != second and edge_set.insert(edge_key(first, second)).second)
+        {
+            edge_list.emplace_back(first, second);
+        }
+    }
+    return edge_list;
+}
+
+}//end of namespace fastsir
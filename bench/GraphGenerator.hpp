@@ -0,0 +1,50 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef GRAPHGENERATOR_HPP_
+#define GRAPHGENERATOR_HPP_
+
+#include "Network.hpp"
+#include "SamplableSet/SamplableSet.hpp"
+
+namespace fastsir
+{//start of namespace fastsir
+
+//G(n,p) random graph with the given mean degree
+EdgeList erdos_renyi_graph(std::size_t number_of_nodes, double mean_degree,
+        sset::RNGType& gen);
+
+//ring lattice with k neighbors per node (k even), with each edge rewired
+//with probability p
+EdgeList watts_strogatz_graph(std::size_t number_of_nodes, unsigned int k,
+        double p, sset::RNGType& gen);
+
+//configuration model with P(k) ~ k^-exponent for k in [min_degree, sqrt(n)];
+//self-loops and multi-edges are discarded
+EdgeList power_law_graph(std::size_t number_of_nodes, double exponent,
+        unsigned int min_degree, sset::RNGType& gen);
+
+}//end of namespace fastsir
+
+#endif /* GRAPHGENERATOR_HPP_ */
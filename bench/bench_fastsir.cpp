@@ -0,0 +1,392 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//benchmarks of the sampling structures and of each model
+//
+//usage: fastsir_bench [--quick] [--repetitions n] [--filter group]
+//                     [--output report.json]
+//
+//the report is written as JSON; every benchmark is seeded, so that the
+//work done is the same from one run to another
+
+#include "Benchmark.hpp"
+#include "GraphGenerator.hpp"
+#include "AnnealedContinuousSIR.hpp"
+#include "ContinuousSIR.hpp"
+#include "DiscreteSIR.hpp"
+#include "NextReactionSIR.hpp"
+#include "WeightedContinuousSIR.hpp"
+#include <fstream>
+#include <iostream>
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace fastsir;
+
+const unsigned int SEED = 42;
+const size_t NUMBER_OF_INITIAL_INFECTED = 10;
+
+
+//benchmarks of SamplableSet operations for weights spread over
+//[1,10^spread]; each operation is applied to all elements
+static void bench_samplable_set(vector<BenchmarkResult>& result_vector,
+        size_t number_of_elements, unsigned int repetitions)
+{
+    for (int spread : {1, 3, 6})
+    {
+        double max_weight = pow(10., spread);
+        sset::RNGType gen(SEED);
+        uniform_real_distribution<double> random_log_weight(0., log(max_weight));
+        vector<double> weight_vector(number_of_elements);
+        for (double& weight : weight_vector)
+        {
+            weight = min(exp(random_log_weight(gen)), max_weight);
+        }
+        BenchmarkParameters parameters({{"elements", to_string(number_of_elements)},
+                {"weight_spread", "1e" + to_string(spread)}});
+        unique_ptr<sset::SamplableSet<Node>> samplable_set;
+        auto new_set = [&]()
+            {samplable_set.reset(new sset::SamplableSet<Node>(1., max_weight));};
+        auto fill_set = [&]()
+            {new_set();
+             for (Node node = 0; node < number_of_elements; node++)
+                 samplable_set->insert(node, weight_vector[node]);};
+
+        result_vector.push_back(run_benchmark("SamplableSet", "insert", parameters,
+                    repetitions, new_set, [&]()
+            {
+                for (Node node = 0; node < number_of_elements; node++)
+                {
+                    samplable_set->insert(node, weight_vector[node]);
+                }
+                return number_of_elements;
+            }));
+        result_vector.push_back(run_benchmark("SamplableSet", "set_weight", parameters,
+                    repetitions, fill_set, [&]()
+            {
+                for (Node node = 0; node < number_of_elements; node++)
+                {
+                    samplable_set->set_weight(node,
+                            weight_vector[number_of_elements - node - 1]);
+                }
+                return number_of_elements;
+            }));
+        result_vector.push_back(run_benchmark("SamplableSet", "sample", parameters,
+                    repetitions, [&](){fill_set(); sset::BaseSamplableSet::seed(SEED);}, [&]()
+            {
+                double total = 0.;
+                for (size_t i = 0; i < number_of_elements; i++)
+                {
+                    total += samplable_set->sample()->second;
+                }
+                return number_of_elements + 0.*total;
+            }));
+        result_vector.push_back(run_benchmark("SamplableSet", "sample_n", parameters,
+                    repetitions, [&](){fill_set(); sset::BaseSamplableSet::seed(SEED);}, [&]()
+            {
+                vector<Node> sample;
+                samplable_set->sample_n(number_of_elements, sample);
+                return sample.size();
+            }));
+        result_vector.push_back(run_benchmark("SamplableSet", "erase", parameters,
+                    repetitions, fill_set, [&]()
+            {
+                for (Node node = 0; node < number_of_elements; node++)
+                {
+                    samplable_set->erase(node);
+                }
+                return number_of_elements;
+            }));
+    }
+}
+
+//benchmarks of the hashing of weights to groups, compared with the
+//floor(log2(weight/min_weight)) reference
+static void bench_hash_propensity(vector<BenchmarkResult>& result_vector,
+        size_t number_of_operations, unsigned int repetitions)
+{
+    for (int spread : {1, 6})
+    {
+        double max_weight = pow(10., spread);
+        sset::RNGType gen(SEED);
+        uniform_real_distribution<double> random_log_weight(0., log(max_weight));
+        vector<double> weight_vector(number_of_operations);
+        for (double& weight : weight_vector)
+        {
+            weight = min(exp(random_log_weight(gen)), max_weight);
+        }
+        BenchmarkParameters parameters({{"operations", to_string(number_of_operations)},
+                {"weight_spread", "1e" + to_string(spread)}});
+        sset::HashPropensity hash(1., max_weight);
+        size_t total = 0;
+
+        result_vector.push_back(run_benchmark("HashPropensity", "hash", parameters,
+                    repetitions, [](){}, [&]()
+            {
+                for (double weight : weight_vector)
+                {
+                    total += hash(weight);
+                }
+                return number_of_operations + 0.*total;
+            }));
+        result_vector.push_back(run_benchmark("HashPropensity", "log2_reference", parameters,
+                    repetitions, [](){}, [&]()
+            {
+                for (double weight : weight_vector)
+                {
+                    total += size_t(floor(log2(weight/1.)));
+                }
+                return number_of_operations + 0.*total;
+            }));
+    }
+}
+
+//benchmarks of BinaryTree leaf updates and leaf sampling
+static void bench_binary_tree(vector<BenchmarkResult>& result_vector,
+        size_t number_of_operations, unsigned int repetitions)
+{
+    for (unsigned int number_of_leaves : {16, 64})
+    {
+        BenchmarkParameters parameters({{"leaves", to_string(number_of_leaves)},
+                {"operations", to_string(number_of_operations)}});
+        sset::BinaryTree tree(number_of_leaves);
+        sset::RNGType gen;
+        uniform_real_distribution<double> random_01(0.,1.);
+        auto setup = [&]()
+            {tree = sset::BinaryTree(number_of_leaves); gen.seed(SEED);
+             for (unsigned int leaf = 0; leaf < number_of_leaves; leaf++)
+                 tree.update_value(leaf, 1.);};
+
+        result_vector.push_back(run_benchmark("BinaryTree", "update_value", parameters,
+                    repetitions, setup, [&]()
+            {
+                for (size_t i = 0; i < number_of_operations; i++)
+                {
+                    tree.update_value(i % number_of_leaves, random_01(gen) - 0.5);
+                }
+                return number_of_operations;
+            }));
+        result_vector.push_back(run_benchmark("BinaryTree", "get_leaf_index", parameters,
+                    repetitions, setup, [&]()
+            {
+                size_t total = 0;
+                for (size_t i = 0; i < number_of_operations; i++)
+                {
+                    total += tree.get_leaf_index(random_01(gen));
+                }
+                return number_of_operations + 0.*total;
+            }));
+    }
+}
+
+//graphs used for the benchmarks of the models
+static EdgeList make_graph(const string& graph, size_t number_of_nodes)
+{
+    sset::RNGType gen(SEED);
+    if (graph == "erdos_renyi")
+    {
+        return erdos_renyi_graph(number_of_nodes, 10., gen);
+    }
+    if (graph == "watts_strogatz")
+    {
+        return watts_strogatz_graph(number_of_nodes, 10, 0.1, gen);
+    }
+    return power_law_graph(number_of_nodes, 2.5, 3, gen);
+}
+
+//benchmarks of the construction of networks
+static void bench_network(vector<BenchmarkResult>& result_vector,
+        const vector<size_t>& size_vector, unsigned int repetitions)
+{
+    for (const string graph : {"erdos_renyi", "watts_strogatz", "power_law"})
+    {
+        for (size_t number_of_nodes : size_vector)
+        {
+            EdgeList edge_list = make_graph(graph, number_of_nodes);
+            BenchmarkParameters parameters({{"graph", graph},
+                    {"nodes", to_string(number_of_nodes)},
+                    {"edges", to_string(edge_list.size())}});
+            result_vector.push_back(run_benchmark("Network", "construction", parameters,
+                        repetitions, [](){}, [&]()
+                {
+                    Network network(edge_list);
+                    return edge_list.size() + 0.*network.size();
+                }));
+        }
+    }
+}
+
+//run the process until extinction; the number of events is the number of
+//infections and recoveries
+static double evolve_to_extinction(BaseContagion& process)
+{
+    process.evolve(numeric_limits<double>::infinity(), false, false);
+    return 2.*get<3>(process.get_current_macro_state()) - NUMBER_OF_INITIAL_INFECTED;
+}
+
+//benchmarks of full simulations of each model
+template <typename Selected>
+static void bench_models(vector<BenchmarkResult>& result_vector,
+        const vector<size_t>& size_vector, unsigned int repetitions, Selected selected)
+{
+    const double recovery_rate = 1.;
+    const double transmission_rate = 0.3;
+    const double recovery_probability = 0.5;
+    const double transmission_probability = 0.1;
+
+    for (const string graph : {"erdos_renyi", "watts_strogatz", "power_law"})
+    {
+        for (size_t number_of_nodes : size_vector)
+        {
+            EdgeList edge_list = make_graph(graph, number_of_nodes);
+            Network network(edge_list);
+            vector<double> infection_rate, infection_probability;
+            for (size_t k = 0; k <= network.max_degree(); k++)
+            {
+                infection_rate.push_back(transmission_rate*k);
+                infection_probability.push_back(1 - pow(1 - transmission_probability, k));
+            }
+            DegreeDistribution degree_distribution;
+            for (Node node : network.nodes())
+            {
+                degree_distribution[network.degree(node)] += 1;
+            }
+            unordered_set<Node> initial_node_set;
+            for (Node node = 0; node < NUMBER_OF_INITIAL_INFECTED; node++)
+            {
+                initial_node_set.insert(node*(network.size()/NUMBER_OF_INITIAL_INFECTED));
+            }
+            BenchmarkParameters parameters({{"graph", graph},
+                    {"nodes", to_string(network.size())},
+                    {"edges", to_string(edge_list.size())}});
+
+            //unit weights, for a comparison with ContinuousSIR
+            vector<double> edge_weight(edge_list.size(), 1.);
+            vector<pair<string,function<BaseContagion*()>>> model_vector({
+                {"ContinuousSIR", [&](){return new ContinuousSIR(edge_list,
+                        recovery_rate, infection_rate);}},
+                {"WeightedContinuousSIR", [&](){return new WeightedContinuousSIR(
+                        edge_list, edge_weight, recovery_rate,
+                        {0., transmission_rate});}},
+                {"NextReactionSIR", [&](){return new NextReactionSIR(edge_list,
+                        recovery_rate, infection_rate);}},
+                {"DiscreteSIR", [&](){return new DiscreteSIR(edge_list,
+                        recovery_probability, infection_probability);}},
+                {"AnnealedContinuousSIR", [&](){return new AnnealedContinuousSIR(
+                        degree_distribution, recovery_rate, infection_rate);}}});
+            for (auto& model : model_vector)
+            {
+                if (not selected(model.first))
+                {
+                    continue;
+                }
+                unique_ptr<BaseContagion> process(model.second());
+                result_vector.push_back(run_benchmark(model.first, "evolve", parameters,
+                            repetitions, [&]()
+                    {
+                        process->reset();
+                        process->seed(SEED);
+                        process->infect_node_set(initial_node_set);
+                    }, [&](){return evolve_to_extinction(*process);}));
+            }
+        }
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+    unsigned int repetitions = 3;
+    string filter;
+    string output_path;
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument == "--quick")
+        {
+            quick = true;
+        }
+        else if (argument == "--repetitions" and i + 1 < argc)
+        {
+            repetitions = max(1, stoi(argv[++i]));
+        }
+        else if (argument == "--filter" and i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (argument == "--output" and i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--quick] [--repetitions n] "
+                 << "[--filter group] [--output report.json]" << endl;
+            return 2;
+        }
+    }
+
+    vector<size_t> size_vector = quick ? vector<size_t>({1000}) :
+        vector<size_t>({1000, 10000, 100000});
+    size_t number_of_elements = quick ? 10000 : 1000000;
+
+    auto selected = [&](const string& group)
+        {return filter.empty() or group.find(filter) != string::npos;};
+    vector<BenchmarkResult> result_vector;
+    if (selected("SamplableSet"))
+    {
+        bench_samplable_set(result_vector, number_of_elements, repetitions);
+    }
+    if (selected("HashPropensity"))
+    {
+        bench_hash_propensity(result_vector, number_of_elements, repetitions);
+    }
+    if (selected("BinaryTree"))
+    {
+        bench_binary_tree(result_vector, number_of_elements, repetitions);
+    }
+    if (selected("Network"))
+    {
+        bench_network(result_vector, size_vector, repetitions);
+    }
+    bench_models(result_vector, size_vector, repetitions, selected);
+
+    BenchmarkParameters context({{"seed", to_string(SEED)},
+            {"repetitions", to_string(repetitions)},
+            {"mode", quick ? "quick" : "full"},
+            {"compiler", __VERSION__}});
+    if (output_path.empty())
+    {
+        write_json(cout, context, result_vector);
+    }
+    else
+    {
+        ofstream output(output_path);
+        write_json(output, context, result_vector);
+    }
+    return 0;
+}
@@ -38,20 +38,52 @@
 # derivative works thereof, in binary and source code form.
 
 
-from glob import glob
-from pybind11.setup_helpers import Pybind11Extension, build_ext
-from setuptools import setup
+import os
+import subprocess
+import sys
+from pathlib import Path
+import pybind11
+from setuptools import setup, Extension
+from setuptools.command.build_ext import build_ext
 import setuptools
 
 __version__ = '0.0.1'
 
-ext_modules = [
-    Pybind11Extension("fastsir",
-        sorted(glob("src/[!_]*.cpp")) + sorted(glob("src/SamplableSet/*.cpp")),  # Sort source files for reproducibility
-        include_dirs = ["src/"],
-        define_macros = [('VERSION_INFO', __version__)],
-        ),
-]
+
+# The module is built by CMake on top of the fastsir library, so that the
+# sources and compile options are listed only in CMakeLists.txt
+class CMakeExtension(Extension):
+    def __init__(self, name, source_dir=""):
+        Extension.__init__(self, name, sources=[])
+        self.source_dir = os.fspath(Path(source_dir).resolve())
+
+
+class CMakeBuild(build_ext):
+    def build_extension(self, ext):
+        ext_dir = Path(self.get_ext_fullpath(ext.name)).parent.resolve()
+        build_type = "Debug" if self.debug else "Release"
+        cmake_args = [
+            f"-DCMAKE_LIBRARY_OUTPUT_DIRECTORY={ext_dir}{os.sep}",
+            f"-DCMAKE_LIBRARY_OUTPUT_DIRECTORY_{build_type.upper()}={ext_dir}{os.sep}",
+            f"-DCMAKE_BUILD_TYPE={build_type}",
+            f"-DPYTHON_EXECUTABLE={sys.executable}",
+            f"-DPython_EXECUTABLE={sys.executable}",
+            f"-Dpybind11_DIR={pybind11.get_cmake_dir()}",
+            "-DFASTSIR_BUILD_PYTHON=ON",
+            "-DFASTSIR_BUILD_CLI=OFF",
+            "-DFASTSIR_BUILD_BENCH=OFF",
+            "-DFASTSIR_BUILD_TESTS=OFF",
+            f"-DFASTSIR_PROFILE={'ON' if os.environ.get('FASTSIR_PROFILE') else 'OFF'}",
+        ]
+        build_dir = Path(self.build_temp) / ext.name
+        build_dir.mkdir(parents=True, exist_ok=True)
+        subprocess.run(["cmake", "-S", ext.source_dir, "-B", build_dir] + cmake_args,
+                       check=True)
+        subprocess.run(["cmake", "--build", build_dir, "--config", build_type,
+                        "--target", "fastsir_python", "--parallel"], check=True)
+
+
+ext_modules = [CMakeExtension("fastsir")]
 
 
 setup(
@@ -65,6 +97,6 @@ setup(
     packages=setuptools.find_packages(),
     ext_modules=ext_modules,
     install_requires=['pybind11>=2.2'],
-    cmdclass={'build_ext': build_ext},
+    cmdclass={'build_ext': CMakeBuild},
     zip_safe=False,
 )
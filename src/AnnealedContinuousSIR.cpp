@@ -29,109 +29,358 @@
 #include <exception>
 #include <cmath>
 #include <limits>
+#include <algorithm>
 
 using namespace std;
 
 namespace fastsir
 {//start of namespace fastsir
 
-//dummy edge list of a star graph
-EdgeList dummy_edge_list(int number_of_nodes)
+//binomial coefficients times the infection rates, in floating point
+vector<double> meanfield_coefficients(int degree, const vector<double>& infection_rate)
 {
-    EdgeList v;
-    for (int i = 0; i < number_of_nodes; i++)
+    vector<double> coeff(degree+1);
+    double binomial_coeff = 1.;
+    for (int i = 0; i <= degree; i++)
     {
-        v.push_back(make_pair(0,i));
+        coeff[i] = binomial_coeff*infection_rate.at(i);
+        binomial_coeff *= double(degree - i)/(i + 1);
     }
-    return v;
+    return coeff;
 }
 
-//to calculate binomial coefficient
-int BinomialCoefficient(const int n, const int k) {
-  vector<int> aSolutions(k);
-  aSolutions[0] = n - k + 1;
+//average infection rate sum_i C(k,i) p^i (1-p)^(k-i) rate_i for a binomial
+//infected degree; coeff contains C(k,i)*rate_i. The polynomial is evaluated
+//with Horner's scheme in p/(1-p) or (1-p)/p, whichever is below 1, so all
+//terms are positive and no power is computed in the loop. If the binomial
+//coefficients overflow (degree above ~1000), de Casteljau's algorithm is used.
+double meanfield_rate(const vector<double>& coeff, const vector<double>& infection_rate,
+        double p)
+{
+    int degree = coeff.size() - 1;
+    if (not isfinite(coeff[degree/2]))
+    {
+        vector<double> value(infection_rate.begin(), infection_rate.begin() + degree + 1);
+        for (int j = degree; j > 0; j--)
+        {
+            for (int i = 0; i < j; i++)
+            {
+                value[i] = (1-p)*value[i] + p*value[i+1];
+            }
+        }
+        return value[0];
+    }
+    double sum;
+    if (p <= 0.5)
+    {
+        double x = p/(1-p);
+        sum = coeff[degree];
+        for (int i = degree-1; i >= 0; i--)
+        {
+            sum = sum*x + coeff[i];
+        }
+        return sum*pow(1-p, degree);
+    }
+    else
+    {
+        double y = (1-p)/p;
+        sum = coeff[0];
+        for (int i = 1; i <= degree; i++)
+        {
+            sum = sum*y + coeff[i];
+        }
+        return sum*pow(p, degree);
+    }
+}
 
-  for (int i = 1; i < k; ++i) {
-    aSolutions[i] = aSolutions[i - 1] * (n - k + 1 + i) / (i + 1);
-  }
+//probability of an infected degree i for a binomial infected degree,
+//computed in logarithmic scale to handle large degrees
+double binomial_probability(int degree, int i, double p)
+{
+    if (p == 0. or p == 1.)
+    {
+        return (i == (p == 0. ? 0 : degree)) ? 1. : 0.;
+    }
+    return exp(lgamma(degree + 1.) - lgamma(i + 1.) - lgamma(degree - i + 1.)
+            + i*log(p) + (degree - i)*log1p(-p));
+}
 
-  return aSolutions[k - 1];
+//constructor of the class for a homogeneous degree
+AnnealedContinuousSIR::AnnealedContinuousSIR(size_t number_of_nodes, int degree, double recovery_rate,
+        const vector<double>& infection_rate):
+    AnnealedContinuousSIR(DegreeDistribution({{degree, number_of_nodes}}),
+            recovery_rate, infection_rate)
+{
 }
 
-//constructor of the class
-AnnealedContinuousSIR::AnnealedContinuousSIR(int number_of_nodes, int degree, double recovery_rate,
+//constructor of the class for a degree sequence
+AnnealedContinuousSIR::AnnealedContinuousSIR(const vector<int>& degree_sequence, double recovery_rate,
         const vector<double>& infection_rate):
-    BaseContagion(dummy_edge_list(number_of_nodes)),
-    degree_(degree),
-    binomial_coeff_(degree+1,0),
+    BaseContagion(),
     recovery_rate_(recovery_rate),
-    infection_rate_(infection_rate),
-    infection_event_set_(1.,1.),
-    recovery_event_set_(1.,1.)
+    infection_rate_(infection_rate)
 {
-    //by default, we populate the infection event set with all susceptible nodes
-    for (Node node = 0; node < size(); node++)
+    DegreeDistribution degree_distribution;
+    for (int degree : degree_sequence)
     {
-        infection_event_set_.insert(node,1.);
+        degree_distribution[degree] += 1;
     }
-    //precalculate the binomial coefficients
-    for (int i = 0; i <= degree; i++)
+    initialize_classes(degree_distribution);
+}
+
+//constructor of the class for a degree distribution (number of nodes of
+//each degree)
+AnnealedContinuousSIR::AnnealedContinuousSIR(const DegreeDistribution& degree_distribution,
+        double recovery_rate, const vector<double>& infection_rate):
+    BaseContagion(),
+    recovery_rate_(recovery_rate),
+    infection_rate_(infection_rate)
+{
+    initialize_classes(degree_distribution);
+}
+
+//group the nodes in degree classes
+void AnnealedContinuousSIR::initialize_classes(const DegreeDistribution& degree_distribution)
+{
+    number_of_nodes_ = 0;
+    total_degree_ = 0.;
+    for (const pair<const int,size_t>& degree_count : degree_distribution)
+    {
+        if (degree_count.first < 0)
+        {
+            throw invalid_argument("Negative degree");
+        }
+        if (degree_count.second == 0)
+        {
+            continue;
+        }
+        degree_vector_.push_back(degree_count.first);
+        class_size_vector_.push_back(degree_count.second);
+        label_offset_vector_.push_back(number_of_nodes_);
+        meanfield_coeff_vector_.push_back(
+                meanfield_coefficients(degree_count.first, infection_rate_));
+        number_of_nodes_ += degree_count.second;
+        total_degree_ += double(degree_count.first)*degree_count.second;
+    }
+    if (number_of_nodes_ == 0)
+    {
+        throw invalid_argument("The network must have at least one node");
+    }
+    meanfield_infection_rate_vector_.assign(degree_vector_.size(), 0.);
+    infected_label_vector_.assign(degree_vector_.size(),
+            vector<pair<Node,Generation>>());
+    infected_vector_.assign(degree_vector_.size(), 0);
+    recovered_vector_.assign(degree_vector_.size(), 0);
+    clear();
+}
+
+//get a random degree class with probability weight(c)/total_weight
+template <typename WeightFunc>
+DegreeClass AnnealedContinuousSIR::random_degree_class(WeightFunc weight,
+        double total_weight) const
+{
+    double r = random_01_(gen_)*total_weight;
+    double cumul = 0.;
+    DegreeClass last_class = 0;
+    for (DegreeClass c = 0; c < degree_vector_.size(); c++)
     {
-        binomial_coeff_[i] = BinomialCoefficient(degree_, i);
+        if (weight(c) > 0)
+        {
+            cumul += weight(c);
+            last_class = c;
+            if (r < cumul)
+            {
+                break;
+            }
+        }
     }
+    return last_class;
 }
 
-//update the infection rate of a neighbor node
+//update the average infection rate of susceptible nodes in each class;
+//the infected degree is binomial with the probability that an edge leads
+//to an infected node
 inline void AnnealedContinuousSIR::update_meanfield_rate()
 {
-    double prevalence = double(get_number_of_infected_nodes())/size();
-    double sum = 0.;
-    for (int i = 0; i <= degree_ ; i++)
+    double edge_prevalence = get_edge_prevalence();
+    total_infection_rate_ = 0.;
+    for (DegreeClass c = 0; c < degree_vector_.size(); c++)
     {
-        sum += binomial_coeff_[i]*pow(prevalence,i)*pow(1-prevalence,degree_-i)*get_infection_rate(i);
+        if (get_number_of_susceptible_nodes(c) > 0)
+        {
+            meanfield_infection_rate_vector_[c] = meanfield_rate(
+                    meanfield_coeff_vector_[c], infection_rate_, edge_prevalence);
+            total_infection_rate_ += meanfield_infection_rate_vector_[c]
+                *get_number_of_susceptible_nodes(c);
+        }
+        else
+        {
+            meanfield_infection_rate_vector_[c] = 0.;
+        }
     }
-    meanfield_infection_rate_ = sum;
 }
 
-//infect a node
-inline void AnnealedContinuousSIR::infect(Node node)
+//draw the infected degree of a newly infected node of a class
+InfectedDegree AnnealedContinuousSIR::random_infected_degree(DegreeClass c) const
 {
-    if (state_vector_[node] == S)
+    int degree = degree_vector_[c];
+    double edge_prevalence = get_edge_prevalence();
+    double r = random_01_(gen_)*meanfield_infection_rate_vector_[c];
+    double cumul = 0.;
+    for (int i = 0; i < degree ; i++)
     {
-        infection_event_set_.erase(node);
-        state_vector_[node] = I;
-        infected_node_set_.insert(node);
+        cumul += binomial_probability(degree, i, edge_prevalence)*get_infection_rate(i);
+        if (r < cumul)
+        {
+            return i;
+        }
+    }
+    return degree;
+}
 
-        //create a recovery event for the node
-        recovery_event_set_.insert(node, 1.);
+//add the infection events to the transmission tree; the infector is an
+//infected node chosen proportionally to its degree
+void AnnealedContinuousSIR::update_transmission_tree(const std::vector<Event>& event_vector)
+{
+    if (not track_nodes_)
+    {
+        if (number_of_nodes_ - 1 > numeric_limits<Node>::max())
+        {
+            throw runtime_error("The transmission tree requires labels that fit in a Node");
+        }
+        //nodes infected before are labeled as the last ones, and are roots
+        track_nodes_ = true;
+        for (DegreeClass c = 0; c < degree_vector_.size(); c++)
+        {
+            for (size_t label = get_next_label(c) - infected_vector_[c];
+                    label < get_next_label(c); label++)
+            {
+                infected_label_vector_[c].emplace_back(label, 0);
+            }
+        }
+    }
+    for (const Event& event : event_vector)
+    {
+        if (event.second == INFECTION)
+        {
+            DegreeClass infector_class = random_degree_class(
+                    [this](DegreeClass c)
+                    {return double(degree_vector_[c])*infected_vector_[c];},
+                    infected_degree_sum_);
+            const vector<pair<Node,Generation>>& label_vector =
+                infected_label_vector_[infector_class];
+            size_t index = floor(random_01_(gen_)*label_vector.size());
+            Node infector = label_vector[index].first;
+            Generation generation = label_vector[index].second;
+            next_generation_ = generation + 1;
+            DegreeClass c = event.first;
+            transmission_tree_.emplace_back(current_time_,generation,infector,
+                    get_next_label(c),random_infected_degree(c));
+        }
+    }
+}
+
+//infect a node of a class; the label is given in order of infection within
+//the class
+inline void AnnealedContinuousSIR::infect(Node degree_class)
+{
+    DegreeClass c = degree_class;
+    if (get_number_of_susceptible_nodes(c) > 0)
+    {
+        if (track_nodes_)
+        {
+            infected_label_vector_[c].emplace_back(get_next_label(c), next_generation_);
+        }
+        infected_vector_[c] += 1;
+        number_of_infected_nodes_ += 1;
+        infected_degree_sum_ += degree_vector_[c];
+        next_generation_ = 0;
 
         //update the meanfield
         update_meanfield_rate();
     }
     else
     {
-        throw runtime_error("Infection attempt: the node is not susceptible");
+        throw runtime_error("Infection attempt: no susceptible node in the class");
     }
 }
 
-//recover a node
-inline void AnnealedContinuousSIR::recover(Node node)
+//recover a node of a class; since nodes of a class are exchangeable, a
+//random infected node of the class is removed from the labels
+inline void AnnealedContinuousSIR::recover(Node degree_class)
 {
-    if (state_vector_[node] == I)
+    DegreeClass c = degree_class;
+    if (infected_vector_[c] > 0)
     {
-        state_vector_[node] = R;
-        infected_node_set_.erase(node);
-        recovered_node_set_.insert(node);
-        //erase the recovery event for the node
-        recovery_event_set_.erase(node);
+        infected_vector_[c] -= 1;
+        recovered_vector_[c] += 1;
+        number_of_infected_nodes_ -= 1;
+        number_of_recovered_nodes_ += 1;
+        infected_degree_sum_ -= degree_vector_[c];
+        if (track_nodes_)
+        {
+            vector<pair<Node,Generation>>& label_vector = infected_label_vector_[c];
+            size_t index = floor(random_01_(gen_)*label_vector.size());
+            swap(label_vector[index], label_vector.back());
+            label_vector.pop_back();
+        }
 
         //update the meanfield
         update_meanfield_rate();
     }
     else
     {
-        throw runtime_error("Recovery attempt: the node is not infected");
+        throw runtime_error("Recovery attempt: no infected node in the class");
+    }
+}
+
+//infect a fraction of the nodes of each class initially
+void AnnealedContinuousSIR::infect_fraction(double fraction)
+{
+    for (DegreeClass c = 0; c < degree_vector_.size(); c++)
+    {
+        size_t number_of_infection = floor(class_size_vector_[c]*fraction);
+        number_of_infection = min(number_of_infection, get_number_of_susceptible_nodes(c));
+        if (track_nodes_)
+        {
+            for (size_t i = 0; i < number_of_infection; i++)
+            {
+                infected_label_vector_[c].emplace_back(get_next_label(c) + i, 0);
+            }
+        }
+        infected_vector_[c] += number_of_infection;
+        number_of_infected_nodes_ += number_of_infection;
+        infected_degree_sum_ += double(degree_vector_[c])*number_of_infection;
+    }
+    update_meanfield_rate();
+}
+
+//infect as many random nodes as in the node set; labels are not kept
+void AnnealedContinuousSIR::infect_node_set(const std::unordered_set<Node>& node_set)
+{
+    for (size_t i = 0; i < node_set.size(); i++)
+    {
+        size_t number_of_susceptible_nodes = number_of_nodes_
+            - number_of_infected_nodes_ - number_of_recovered_nodes_;
+        DegreeClass c = random_degree_class([this](DegreeClass c)
+                {return double(get_number_of_susceptible_nodes(c));},
+                number_of_susceptible_nodes);
+        infect(c);
+    }
+}
+
+//get the degree, the number of susceptible, infected and recovered nodes
+//for each degree class
+vector<tuple<int,size_t,size_t,size_t>> AnnealedContinuousSIR::get_degree_class_state() const
+{
+    vector<tuple<int,size_t,size_t,size_t>> degree_class_state;
+    for (DegreeClass c = 0; c < degree_vector_.size(); c++)
+    {
+        degree_class_state.emplace_back(degree_vector_[c],
+                get_number_of_susceptible_nodes(c), infected_vector_[c],
+                recovered_vector_[c]);
     }
+    return degree_class_state;
 }
 
 
@@ -143,17 +392,22 @@ inline vector<Event> AnnealedContinuousSIR::next_step()
     vector<Event> event_vector;
 
     //determine if the next event is infection or recovery
-    if ((meanfield_infection_rate_*infection_event_set_.total_weight()/get_total_rate()) > random_01_(gen_))
+    if ((total_infection_rate_/get_total_rate()) > random_01_(gen_))
     {
         //infection event
-        Node node = (infection_event_set_.sample()).value().first;
-        event_vector.emplace_back(node,INFECTION);
+        DegreeClass c = random_degree_class([this](DegreeClass c)
+                {return meanfield_infection_rate_vector_[c]
+                *get_number_of_susceptible_nodes(c);},
+                total_infection_rate_);
+        event_vector.emplace_back(c,INFECTION);
     }
     else
     {
-        //recovery event
-        Node node = (recovery_event_set_.sample()).value().first;
-        event_vector.emplace_back(node,RECOVERY);
+        //recovery event; only the class of the node is determined
+        DegreeClass c = random_degree_class([this](DegreeClass c)
+                {return double(infected_vector_[c]);},
+                number_of_infected_nodes_);
+        event_vector.emplace_back(c,RECOVERY);
     }
 
     return event_vector;
@@ -161,18 +415,130 @@ inline vector<Event> AnnealedContinuousSIR::next_step()
 
 
 //clear the state; as if all node became susceptible at this time
-//clear all measures as well
 //overload BaseContagion
 void AnnealedContinuousSIR::clear()
 {
-    BaseContagion::clear();
-    infection_event_set_.clear(); //to avoid numerical error accumulation
-    recovery_event_set_.clear(); //to avoid numerical error accumulation
-    //by default, we populate the infection event set with all susceptible nodes
-    for (Node node = 0; node < size(); node++)
+    fill(infected_vector_.begin(), infected_vector_.end(), 0);
+    fill(recovered_vector_.begin(), recovered_vector_.end(), 0);
+    number_of_infected_nodes_ = 0;
+    number_of_recovered_nodes_ = 0;
+    infected_degree_sum_ = 0.;
+    track_nodes_ = false;
+    for (vector<pair<Node,Generation>>& label_vector : infected_label_vector_)
+    {
+        label_vector.clear();
+    }
+    next_generation_ = 0;
+    update_meanfield_rate();
+}
+
+//write the rates, the degree classes and the number of nodes in each state
+//after the common state; the labels are written if they are tracked
+void AnnealedContinuousSIR::write_state(ostream& stream) const
+{
+    BaseContagion::write_state(stream);
+    sset::write_binary(stream, recovery_rate_);
+    sset::write_binary_vector(stream, infection_rate_);
+    sset::write_binary_vector(stream, degree_vector_);
+    sset::write_binary_vector(stream, vector<uint64_t>(class_size_vector_.begin(),
+                class_size_vector_.end()));
+    sset::write_binary_vector(stream, vector<uint64_t>(infected_vector_.begin(),
+                infected_vector_.end()));
+    sset::write_binary_vector(stream, vector<uint64_t>(recovered_vector_.begin(),
+                recovered_vector_.end()));
+    sset::write_binary(stream, uint8_t(track_nodes_));
+    vector<Node> label_vector;
+    vector<Generation> generation_vector;
+    for (const vector<pair<Node,Generation>>& class_label_vector : infected_label_vector_)
+    {
+        for (const pair<Node,Generation>& label : class_label_vector)
+        {
+            label_vector.push_back(label.first);
+            generation_vector.push_back(label.second);
+        }
+    }
+    sset::write_binary_vector(stream, label_vector);
+    sset::write_binary_vector(stream, generation_vector);
+    sset::write_binary(stream, next_generation_);
+}
+
+//read the state written by write_state; the process must have the same
+//degree classes. The mean-field rates are recomputed from the read rates
+void AnnealedContinuousSIR::read_state(istream& stream)
+{
+    BaseContagion::read_state(stream);
+    sset::read_binary(stream, recovery_rate_);
+    sset::read_binary_vector(stream, infection_rate_);
+    vector<int> degree_vector;
+    vector<uint64_t> class_size_vector;
+    sset::read_binary_vector(stream, degree_vector);
+    sset::read_binary_vector(stream, class_size_vector);
+    if (degree_vector != degree_vector_ or not equal(class_size_vector.begin(),
+                class_size_vector.end(), class_size_vector_.begin(), class_size_vector_.end()))
+    {
+        throw runtime_error("State file was saved with other degree classes");
+    }
+    if (infection_rate_.size() <= size_t(degree_vector_.back()))
+    {
+        throw runtime_error("Inconsistent infection rates in state file");
+    }
+
+    vector<uint64_t> infected_vector;
+    vector<uint64_t> recovered_vector;
+    sset::read_binary_vector(stream, infected_vector);
+    sset::read_binary_vector(stream, recovered_vector);
+    if (infected_vector.size() != degree_vector_.size()
+            or recovered_vector.size() != degree_vector_.size())
+    {
+        throw runtime_error("Inconsistent degree classes in state file");
+    }
+    number_of_infected_nodes_ = 0;
+    number_of_recovered_nodes_ = 0;
+    infected_degree_sum_ = 0.;
+    for (DegreeClass c = 0; c < degree_vector_.size(); c++)
+    {
+        if (infected_vector[c] > class_size_vector_[c]
+                or recovered_vector[c] > class_size_vector_[c] - infected_vector[c])
+        {
+            throw runtime_error("Inconsistent degree classes in state file");
+        }
+        infected_vector_[c] = infected_vector[c];
+        recovered_vector_[c] = recovered_vector[c];
+        number_of_infected_nodes_ += infected_vector[c];
+        number_of_recovered_nodes_ += recovered_vector[c];
+        infected_degree_sum_ += double(degree_vector_[c])*infected_vector[c];
+        meanfield_coeff_vector_[c] = meanfield_coefficients(degree_vector_[c],
+                infection_rate_);
+    }
+
+    track_nodes_ = sset::read_binary<uint8_t>(stream);
+    vector<Node> label_vector;
+    vector<Generation> generation_vector;
+    sset::read_binary_vector(stream, label_vector);
+    sset::read_binary_vector(stream, generation_vector);
+    if (generation_vector.size() != label_vector.size() or label_vector.size()
+            != (track_nodes_ ? number_of_infected_nodes_ : 0))
+    {
+        throw runtime_error("Inconsistent labels in state file");
+    }
+    size_t offset = 0;
+    for (DegreeClass c = 0; c < degree_vector_.size(); c++)
     {
-        infection_event_set_.insert(node,1.);
+        infected_label_vector_[c].clear();
+        for (size_t i = 0; track_nodes_ and i < infected_vector_[c]; i++)
+        {
+            if (label_vector[offset] < label_offset_vector_[c]
+                    or label_vector[offset] >= get_next_label(c))
+            {
+                throw runtime_error("Inconsistent labels in state file");
+            }
+            infected_label_vector_[c].emplace_back(label_vector[offset],
+                    generation_vector[offset]);
+            offset += 1;
+        }
     }
+    sset::read_binary(stream, next_generation_);
+    update_meanfield_rate();
 }
 
 
@@ -26,47 +26,105 @@
 #define ANNEALEDCONTINUOUSSIR_HPP_
 
 #include "BaseContagion.hpp"
+#include <map>
 
 namespace fastsir
 {//start of namespace fastsir
 
 
-//class to simulate SIR process on networks
+typedef std::map<int,std::size_t> DegreeDistribution; //degree -> nb of nodes
+typedef std::size_t DegreeClass;
+
+
+//class to simulate SIR process on annealed networks
+//since nodes of the same degree are exchangeable, only the number of nodes in
+//each state is stored for each degree class, and events refer to a degree
+//class instead of a node. Nodes are labeled in order of infection within
+//their class only if the transmission tree is requested, which requires
+//labels that fit in a Node.
+//The mean-field rate of every class depends on the edge prevalence, so each
+//event updates all classes: the cost per event is O(sum of the class
+//degrees), O(k^2) for a class of degree k above ~1000 whose binomial
+//coefficients overflow, and drawing a class is linear in the number of
+//classes. The number of nodes itself does not enter the cost
 class AnnealedContinuousSIR : public BaseContagion
 {
 public:
     //Constructor
-    AnnealedContinuousSIR(int number_of_nodes, int degree, double recovery_rate,
+    AnnealedContinuousSIR(std::size_t number_of_nodes, int degree, double recovery_rate,
+                          const std::vector<double>& infection_rate);
+    AnnealedContinuousSIR(const std::vector<int>& degree_sequence, double recovery_rate,
+                          const std::vector<double>& infection_rate);
+    AnnealedContinuousSIR(const DegreeDistribution& degree_distribution, double recovery_rate,
                           const std::vector<double>& infection_rate);
 
     //Accessors
+    std::size_t size() const
+        {return number_of_nodes_;}
+    std::size_t get_number_of_infected_nodes() const
+        {return number_of_infected_nodes_;}
+    std::size_t get_number_of_recovered_nodes() const
+        {return number_of_recovered_nodes_;}
     double get_lifetime() const
-        {return infected_node_set_.size() == 0 ?
+        {return number_of_infected_nodes_ == 0 ?
             std::numeric_limits<double>::infinity() : 1./(get_total_rate());}
+    std::vector<std::tuple<int,std::size_t,std::size_t,std::size_t>> get_degree_class_state() const;
 
     //Mutators
+    void infect_fraction(double fraction);
+    void infect_node_set(const std::unordered_set<Node>& node_set);
     void clear();
 
 protected:
     //Members
-    int degree_;
+    std::size_t number_of_nodes_;
     double recovery_rate_;
-    double meanfield_infection_rate_;
-    std::vector<int> binomial_coeff_;
     std::vector<double> infection_rate_;
-    sset::SamplableSet<Node> infection_event_set_;
-    sset::SamplableSet<Node> recovery_event_set_;
+    std::vector<int> degree_vector_;
+    std::vector<std::size_t> class_size_vector_;
+    std::vector<std::size_t> label_offset_vector_; //first label of each class
+    std::vector<std::vector<double>> meanfield_coeff_vector_; //binomial coefficient times rate
+    std::vector<double> meanfield_infection_rate_vector_;
+    std::vector<std::size_t> infected_vector_;
+    std::vector<std::size_t> recovered_vector_;
+    std::size_t number_of_infected_nodes_;
+    std::size_t number_of_recovered_nodes_;
+    double total_degree_;
+    double infected_degree_sum_; //sum of the degrees of infected nodes
+    double total_infection_rate_;
+    bool track_nodes_; //true when the transmission tree is recorded
+    std::vector<std::vector<std::pair<Node,Generation>>> infected_label_vector_;
+    Generation next_generation_; //generation of the next infected node
 
     //utility functions
+    inline std::size_t get_number_of_susceptible_nodes(DegreeClass c) const
+        {return class_size_vector_[c] - infected_vector_[c] - recovered_vector_[c];}
+    inline std::size_t get_next_label(DegreeClass c) const
+        {return label_offset_vector_[c] + infected_vector_[c] + recovered_vector_[c];}
     inline double get_infection_rate(int infected_degree) const
         {return infection_rate_.at(infected_degree);}
     inline double get_total_rate() const
-        {return meanfield_infection_rate_*infection_event_set_.total_weight() + recovery_rate_*recovery_event_set_.total_weight();}
+        {return total_infection_rate_ + recovery_rate_*number_of_infected_nodes_;}
+    inline double get_edge_prevalence() const
+        {return total_degree_ > 0 ? infected_degree_sum_/total_degree_ : 0.;}
 
+    void initialize_classes(const DegreeDistribution& degree_distribution);
+    template <typename WeightFunc>
+    DegreeClass random_degree_class(WeightFunc weight, double total_weight) const;
     inline void update_meanfield_rate();
-    inline void infect(Node node);
-    inline void recover(Node node);
+    InfectedDegree random_infected_degree(DegreeClass c) const;
+    void update_transmission_tree(const std::vector<Event>& event_vector);
+    inline void infect(Node degree_class);
+    inline void recover(Node degree_class);
     inline std::vector<Event> next_step();
+    std::string get_model_name() const
+        {return "AnnealedContinuousSIR";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<AnnealedContinuousSIR>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<AnnealedContinuousSIR&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
 };
 
 }//end of namespace fastsir
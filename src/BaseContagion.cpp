@@ -23,29 +23,61 @@
  */
 
 #include "BaseContagion.hpp"
+#include "Parallel.hpp"
 #include <cmath>
 #include <optional>
 #include <utility>
 #include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <cstdio>
 #include <exception>
+#include <stdexcept>
 
 using namespace std;
 
 namespace fastsir
 {//start of namespace fastsir
 
-//constructor of the class
-BaseContagion::BaseContagion(const EdgeList& edge_list):
-    network_(edge_list),
-    state_vector_(network_.size(), S),
+//first bytes of a state file
+static const char STATE_MAGIC[8] = {'F','A','S','T','S','I','R','S'};
+
+//constructor of the class; for a directed network, an edge (i,j) lets i
+//infect j
+BaseContagion::BaseContagion(const EdgeList& edge_list, bool directed):
+    BaseContagion(std::make_shared<const Network>(edge_list, directed))
+{
+}
+
+//constructor of the class provided the network
+BaseContagion::BaseContagion(std::shared_ptr<const Network> network):
+    network_(move(network)),
+    state_vector_(network_->size(), S),
     infected_node_set_(),
     recovered_node_set_(),
     infection_generation_(),
-    infected_neighbors_vector_(network_.size(), vector<Node>()),
-    infected_neighbor_position_vector_(network_.size(), InfectedNeighborPosition()),
+    infected_neighbors_vector_(network_->size(), vector<Node>()),
+    infected_neighbor_position_vector_(network_->size(), InfectedNeighborPosition()),
     current_time_(0),
     last_event_time_(0),
-    gen_(sset::BaseSamplableSet::gen_),
+    gen_(sset::BaseSamplableSet::gen_()),
+    random_01_()
+{
+}
+
+//constructor of the class without network
+BaseContagion::BaseContagion():
+    network_(std::make_shared<const Network>()),
+    state_vector_(),
+    infected_node_set_(),
+    recovered_node_set_(),
+    infection_generation_(),
+    infected_neighbors_vector_(),
+    infected_neighbor_position_vector_(),
+    current_time_(0),
+    last_event_time_(0),
+    gen_(sset::BaseSamplableSet::gen_()),
     random_01_()
 {
 }
@@ -60,13 +92,11 @@ Node BaseContagion::random_infected_neighbor(Node node) const
 //store the current macro state
 inline void BaseContagion::store_current_macro_state()
 {
-
-    macro_state_vector_.emplace_back(current_time_,network_.size()-infected_node_set_.size()-recovered_node_set_.size(),
-            infected_node_set_.size(),recovered_node_set_.size());
+    macro_state_vector_.push_back(get_current_macro_state());
 }
 
-//store the current macro state
-inline void BaseContagion::update_transmission_tree(const std::vector<Event>& event_vector)
+//add the infection events to the transmission tree
+void BaseContagion::update_transmission_tree(const std::vector<Event>& event_vector)
 {
     for (const Event& event : event_vector)
     {
@@ -86,7 +116,7 @@ inline void BaseContagion::update_transmission_tree(const std::vector<Event>& ev
     }
 }
 
-inline void BaseContagion::apply_events(const vector<Event>& event_vector)
+void BaseContagion::apply_events(const vector<Event>& event_vector)
 {
     for (const Event& event : event_vector)
     {
@@ -100,6 +130,14 @@ inline void BaseContagion::apply_events(const vector<Event>& event_vector)
         {
             recover(node);
         }
+        else if (action == ONSET)
+        {
+            onset(node);
+        }
+        else if (action == WANING)
+        {
+            wane(node);
+        }
     }
 }
 
@@ -107,12 +145,12 @@ inline void BaseContagion::apply_events(const vector<Event>& event_vector)
 //infect a fraction of the nodes initially
 void BaseContagion::infect_fraction(double fraction)
 {
-    unsigned int number_of_infection = floor(network_.size()*fraction);
+    unsigned int number_of_infection = floor(network_->size()*fraction);
     Node node;
     unsigned int count = 0;
     while (count < number_of_infection)
     {
-        node = floor(random_01_(gen_)*network_.size());
+        node = floor(random_01_(gen_)*network_->size());
         if (state_vector_[node] == S)
         {
             infect(node);
@@ -158,41 +196,691 @@ void BaseContagion::clear()
 //clear all measures as well
 void BaseContagion::reset()
 {
-    clear();
     //reset transmission tree and macro state vector
     macro_state_vector_.clear();
     transmission_tree_.clear();
     current_time_ = 0;
     last_event_time_ = 0;
+    clear();
+}
+
+//set new infection rates for each infected degree; only some models support it
+void BaseContagion::set_infection_rate(const vector<double>& infection_rate)
+{
+    check_infection_rate(infection_rate);
+}
+
+//set a new recovery rate; only some models support it
+void BaseContagion::set_recovery_rate(double recovery_rate)
+{
+    check_recovery_rate(recovery_rate);
+}
+
+//models that support new rates override the checks
+void BaseContagion::check_infection_rate(const vector<double>&) const
+{
+    throw runtime_error("The infection rate cannot be changed for this model");
+}
+
+void BaseContagion::check_recovery_rate(double) const
+{
+    throw runtime_error("The recovery rate cannot be changed for this model");
+}
+
+//rates given per infected degree must cover the maximal degree of the
+//network, so that no node can reach a degree without a rate
+void BaseContagion::check_rate_per_degree(const vector<double>& rate_vector) const
+{
+    if (rate_vector.size() <= network_->max_in_degree())
+    {
+        throw invalid_argument("Infection rate must be given up to the maximal degree "
+                + to_string(network_->max_in_degree()));
+    }
+    for (double rate : rate_vector)
+    {
+        if (not (rate >= 0))
+        {
+            throw invalid_argument("Infection rate must be non-negative");
+        }
+    }
+}
+
+//schedule new rates at a given time, applied by evolve; an empty infection
+//rate or a nan recovery rate is left unchanged. Each change is applied once.
+//A change the model cannot apply is rejected here rather than during evolve
+void BaseContagion::schedule_rates(double time, const vector<double>& infection_rate,
+        double recovery_rate)
+{
+    if (not infection_rate.empty())
+    {
+        check_infection_rate(infection_rate);
+    }
+    if (not isnan(recovery_rate))
+    {
+        check_recovery_rate(recovery_rate);
+    }
+    rate_schedule_.emplace(time, RateChange(infection_rate, recovery_rate));
+}
+
+//apply the first scheduled change of rates; in continuous time, the waiting
+//time for the next event restarts at the time of the change. The change is
+//removed from the schedule only once applied; if the new infection rates do
+//not cover an infected degree, the process is left as it was
+void BaseContagion::apply_next_rate_change()
+{
+    auto change = rate_schedule_.begin();
+    const RateChange& rate_change = change->second;
+    double previous_current_time = current_time_;
+    double previous_last_event_time = last_event_time_;
+    double time = max(change->first, last_event_time_);
+    current_time_ = time;
+    if (not is_discrete_time())
+    {
+        last_event_time_ = time;
+    }
+    try
+    {
+        if (not rate_change.first.empty())
+        {
+            set_infection_rate(rate_change.first);
+        }
+    }
+    catch (...)
+    {
+        current_time_ = previous_current_time;
+        last_event_time_ = previous_last_event_time;
+        throw;
+    }
+    //the recovery rate was checked when scheduled
+    if (not isnan(rate_change.second))
+    {
+        set_recovery_rate(rate_change.second);
+    }
+    rate_schedule_.erase(change);
+}
+
+//get the susceptible nodes with at least one infectious neighbor, in order
+vector<Node> BaseContagion::get_nodes_at_risk() const
+{
+    vector<Node> node_vector;
+    vector<char> listed_vector(network_->size(), 0);
+    for (Node infected_node : infected_node_set_)
+    {
+        if (state_vector_[infected_node] != I)
+        {
+            continue; //latent nodes do not infect
+        }
+        for (Node neighbor : network_->adjacent_nodes(infected_node))
+        {
+            if (state_vector_[neighbor] == S and not listed_vector[neighbor])
+            {
+                listed_vector[neighbor] = 1;
+                node_vector.push_back(neighbor);
+            }
+        }
+    }
+    sort(node_vector.begin(), node_vector.end());
+    return node_vector;
 }
 
 //perform the evolution of the process over a period of time and perform
 //measures after each decorrelation time if needed
 void BaseContagion::evolve(double period, bool save_transmission_tree, bool save_macro_state)
 {
+    check_period(period);
     if (save_macro_state and (macro_state_vector_.size() == 0))
     {
         store_current_macro_state();
     }
     double initial_time = current_time_;
+#ifdef FASTSIR_PROFILE
+    //sampling counters are per thread; the process keeps its own share
+    const sset::SamplingCounters initial_counters = sset::BaseSamplableSet::counters_;
+#endif
 
     vector<Event> event_vector;
-    while((last_event_time_ + get_lifetime() - initial_time <= period) and isfinite(get_lifetime()))
+    while (true)
     {
-        event_vector = next_step();
+        //apply the changes of rates scheduled before the next event
+        if (not rate_schedule_.empty()
+                and rate_schedule_.begin()->first < last_event_time_ + get_lifetime()
+                and rate_schedule_.begin()->first - initial_time <= period)
+        {
+            apply_next_rate_change();
+            continue;
+        }
+        if (not ((last_event_time_ + get_lifetime() - initial_time <= period)
+                    and isfinite(get_lifetime())))
+        {
+            break;
+        }
+        {
+            FASTSIR_PROFILE_PHASE(next_step_seconds);
+            event_vector = next_step();
+        }
+#ifdef FASTSIR_PROFILE
+        for (const Event& event : event_vector)
+        {
+            switch (event.second)
+            {
+                case INFECTION: performance_counters_.infection_events += 1; break;
+                case RECOVERY: performance_counters_.recovery_events += 1; break;
+                case ONSET: performance_counters_.onset_events += 1; break;
+                case WANING: performance_counters_.waning_events += 1; break;
+            }
+        }
+#endif
         //save transmission tree
         if (save_transmission_tree and event_vector.size() > 0)
         {
+            FASTSIR_PROFILE_PHASE(transmission_tree_seconds);
             update_transmission_tree(event_vector);
         }
-        apply_events(event_vector);
+        {
+            FASTSIR_PROFILE_PHASE(apply_events_seconds);
+            apply_events(event_vector);
+        }
         //store macro state
         if (save_macro_state)
         {
+            FASTSIR_PROFILE_PHASE(macro_state_seconds);
             store_current_macro_state();
         }
     }
-    current_time_ = initial_time + period;
+#ifdef FASTSIR_PROFILE
+    const sset::SamplingCounters& counters = sset::BaseSamplableSet::counters_;
+    performance_counters_.sample_calls += counters.sample_calls
+        - initial_counters.sample_calls;
+    performance_counters_.rejection_trials += counters.rejection_trials
+        - initial_counters.rejection_trials;
+    performance_counters_.set_weight_calls += counters.set_weight_calls
+        - initial_counters.set_weight_calls;
+#endif
+    //an infinite period runs until no event is left; the time is then
+    //that of the last event
+    if (isfinite(period))
+    {
+        current_time_ = initial_time + period;
+    }
+}
+
+//get the performance counters; empty unless compiled with FASTSIR_PROFILE.
+//The sampling counters only count the work done during evolve
+map<string,double> BaseContagion::get_performance_counters() const
+{
+    map<string,double> counter_map;
+#ifdef FASTSIR_PROFILE
+    counter_map["infection_events"] = performance_counters_.infection_events;
+    counter_map["recovery_events"] = performance_counters_.recovery_events;
+    counter_map["onset_events"] = performance_counters_.onset_events;
+    counter_map["waning_events"] = performance_counters_.waning_events;
+    counter_map["neighbor_visits"] = performance_counters_.neighbor_visits;
+    counter_map["sample_calls"] = performance_counters_.sample_calls;
+    counter_map["rejection_trials"] = performance_counters_.rejection_trials;
+    counter_map["set_weight_calls"] = performance_counters_.set_weight_calls;
+    counter_map["next_step_seconds"] = performance_counters_.next_step_seconds;
+    counter_map["transmission_tree_seconds"] = performance_counters_.transmission_tree_seconds;
+    counter_map["apply_events_seconds"] = performance_counters_.apply_events_seconds;
+    counter_map["macro_state_seconds"] = performance_counters_.macro_state_seconds;
+#endif
+    return counter_map;
+}
+
+//save the state of the process in a binary file, written while the process
+//is paused between calls to evolve. The file holds the node states, the
+//infected neighbors, the event sets, the time, the RNG state, the
+//parameters and the rate schedule; the macro states and transmission tree are kept if
+//save_history is true. The network itself is not saved.
+void BaseContagion::save_state(const string& path, bool save_history) const
+{
+    //write to a temporary file first, so a snapshot is never left half written
+    string temporary_path = path + ".tmp";
+    ofstream stream(temporary_path, ios::binary);
+    if (not stream)
+    {
+        throw runtime_error("Cannot open file " + temporary_path);
+    }
+    save_state(stream, save_history, false);
+    stream.close();
+    if (not stream or rename(temporary_path.c_str(), path.c_str()) != 0)
+    {
+        throw runtime_error("Cannot write file " + path);
+    }
+}
+
+//write the state in a binary stream, with the network if save_network is
+//true; a process loading it may then be built on any network
+void BaseContagion::save_state(ostream& stream, bool save_history,
+        bool save_network) const
+{
+    string model_name = get_model_name();
+    if (model_name.empty())
+    {
+        throw runtime_error("State snapshots are not supported by this model");
+    }
+    stream.write(STATE_MAGIC, sizeof(STATE_MAGIC));
+    sset::write_binary(stream, STATE_VERSION);
+    sset::write_binary_string(stream, model_name);
+
+    sset::write_binary(stream, uint8_t(save_network));
+    if (save_network)
+    {
+        //adjacency lists, in order, then the edge weights and the orientation
+        vector<uint64_t> degree_vector;
+        for (Node node = 0; node < network_->size(); node++)
+        {
+            degree_vector.push_back(network_->degree(node));
+        }
+        sset::write_binary_vector(stream, degree_vector);
+        sset::write_binary_vector(stream, network_->get_neighbor_vector());
+        sset::write_binary(stream, uint8_t(network_->is_weighted()));
+        sset::write_binary_vector(stream, network_->get_weight_vector());
+        sset::write_binary(stream, uint8_t(network_->is_directed()));
+    }
+    write_state(stream);
+
+    sset::write_binary(stream, uint8_t(save_history));
+    if (save_history)
+    {
+        vector<double> time_vector;
+        vector<uint64_t> count_vector;
+        for (const MacroState& macro_state : macro_state_vector_)
+        {
+            time_vector.push_back(get<0>(macro_state));
+            count_vector.push_back(get<1>(macro_state));
+            count_vector.push_back(get<2>(macro_state));
+            count_vector.push_back(get<3>(macro_state));
+        }
+        sset::write_binary_vector(stream, time_vector);
+        sset::write_binary_vector(stream, count_vector);
+
+        time_vector.clear();
+        vector<Node> node_vector;
+        vector<uint64_t> infected_degree_vector;
+        for (const Transmission& transmission : transmission_tree_)
+        {
+            time_vector.push_back(get<0>(transmission));
+            node_vector.push_back(get<1>(transmission));
+            node_vector.push_back(get<2>(transmission));
+            node_vector.push_back(get<3>(transmission));
+            infected_degree_vector.push_back(get<4>(transmission));
+        }
+        sset::write_binary_vector(stream, time_vector);
+        sset::write_binary_vector(stream, node_vector);
+        sset::write_binary_vector(stream, infected_degree_vector);
+    }
+
+    //scheduled changes of rates
+    vector<double> time_vector;
+    vector<uint64_t> size_vector;
+    vector<double> infection_rate_vector;
+    vector<double> recovery_rate_vector;
+    for (const auto& change : rate_schedule_)
+    {
+        time_vector.push_back(change.first);
+        size_vector.push_back(change.second.first.size());
+        infection_rate_vector.insert(infection_rate_vector.end(),
+                change.second.first.begin(), change.second.first.end());
+        recovery_rate_vector.push_back(change.second.second);
+    }
+    sset::write_binary_vector(stream, time_vector);
+    sset::write_binary_vector(stream, size_vector);
+    sset::write_binary_vector(stream, infection_rate_vector);
+    sset::write_binary_vector(stream, recovery_rate_vector);
+}
+
+//load a state saved with save_state; the process must be built on the same
+//network. The RNG is restored as well. Without saved history, the
+//macro states and transmission tree are cleared.
+void BaseContagion::load_state(const string& path)
+{
+    ifstream stream(path, ios::binary);
+    if (not stream)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    load_state(stream);
+}
+
+//read a state from a binary stream; a saved network replaces the network
+//of the process. The stream is read into a copy, so the process is unchanged
+//if it is invalid
+void BaseContagion::load_state(istream& stream)
+{
+    unique_ptr<BaseContagion> process = clone();
+    if (get_model_name().empty() or not process)
+    {
+        throw runtime_error("State snapshots are not supported by this model");
+    }
+    process->read_snapshot(stream);
+    assign(move(*process));
+}
+
+//read a state from a binary stream into the process
+void BaseContagion::read_snapshot(istream& stream)
+{
+    char magic[sizeof(STATE_MAGIC)];
+    if (not stream.read(magic, sizeof(magic))
+            or not equal(magic, magic + sizeof(magic), STATE_MAGIC))
+    {
+        throw runtime_error("Not a fastsir state file");
+    }
+    uint32_t version = sset::read_binary<uint32_t>(stream);
+    if (version != STATE_VERSION)
+    {
+        throw runtime_error("Unsupported state file version");
+    }
+    if (sset::read_binary_string(stream) != get_model_name())
+    {
+        throw runtime_error("State file was saved by another model");
+    }
+
+    if (sset::read_binary<uint8_t>(stream))
+    {
+        vector<uint64_t> degree_vector;
+        vector<Node> neighbor_vector;
+        sset::read_binary_vector(stream, degree_vector);
+        sset::read_binary_vector(stream, neighbor_vector);
+        vector<size_t> offset_vector(1, 0);
+        for (uint64_t degree : degree_vector)
+        {
+            offset_vector.push_back(offset_vector.back() + degree);
+        }
+        if (offset_vector.back() != neighbor_vector.size())
+        {
+            throw runtime_error("Inconsistent network in state file");
+        }
+        bool weighted = sset::read_binary<uint8_t>(stream);
+        vector<double> weight_vector;
+        sset::read_binary_vector(stream, weight_vector);
+        bool directed = sset::read_binary<uint8_t>(stream);
+        try
+        {
+            network_ = make_shared<const Network>(move(offset_vector),
+                    move(neighbor_vector), move(weight_vector), weighted, directed);
+        }
+        catch (const invalid_argument&)
+        {
+            throw runtime_error("Inconsistent network in state file");
+        }
+        state_vector_.assign(network_->size(), S);
+        infected_neighbors_vector_.assign(network_->size(), vector<Node>());
+        infected_neighbor_position_vector_.assign(network_->size(),
+                InfectedNeighborPosition());
+    }
+    read_state(stream);
+
+    macro_state_vector_.clear();
+    transmission_tree_.clear();
+    if (sset::read_binary<uint8_t>(stream))
+    {
+        vector<double> time_vector;
+        vector<uint64_t> count_vector;
+        sset::read_binary_vector(stream, time_vector);
+        sset::read_binary_vector(stream, count_vector);
+        if (count_vector.size() != 3*time_vector.size())
+        {
+            throw runtime_error("Inconsistent macro states in state file");
+        }
+        for (size_t i = 0; i < time_vector.size(); i++)
+        {
+            macro_state_vector_.emplace_back(time_vector[i], count_vector[3*i],
+                    count_vector[3*i+1], count_vector[3*i+2]);
+        }
+
+        vector<Node> node_vector;
+        vector<uint64_t> infected_degree_vector;
+        sset::read_binary_vector(stream, time_vector);
+        sset::read_binary_vector(stream, node_vector);
+        sset::read_binary_vector(stream, infected_degree_vector);
+        if (node_vector.size() != 3*time_vector.size()
+                or infected_degree_vector.size() != time_vector.size())
+        {
+            throw runtime_error("Inconsistent transmission tree in state file");
+        }
+        for (size_t i = 0; i < time_vector.size(); i++)
+        {
+            transmission_tree_.emplace_back(time_vector[i], node_vector[3*i],
+                    node_vector[3*i+1], node_vector[3*i+2], infected_degree_vector[i]);
+        }
+    }
+
+    //scheduled changes of rates
+    rate_schedule_.clear();
+    vector<double> time_vector;
+    vector<uint64_t> size_vector;
+    vector<double> infection_rate_vector;
+    vector<double> recovery_rate_vector;
+    sset::read_binary_vector(stream, time_vector);
+    sset::read_binary_vector(stream, size_vector);
+    sset::read_binary_vector(stream, infection_rate_vector);
+    sset::read_binary_vector(stream, recovery_rate_vector);
+    if (size_vector.size() != time_vector.size()
+            or recovery_rate_vector.size() != time_vector.size())
+    {
+        throw runtime_error("Inconsistent rate schedule in state file");
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < time_vector.size(); i++)
+    {
+        if (offset + size_vector[i] > infection_rate_vector.size())
+        {
+            throw runtime_error("Inconsistent rate schedule in state file");
+        }
+        rate_schedule_.emplace(time_vector[i], RateChange(vector<double>(
+                        infection_rate_vector.begin() + offset,
+                        infection_rate_vector.begin() + offset + size_vector[i]),
+                    recovery_rate_vector[i]));
+        offset += size_vector[i];
+    }
+}
+
+//copy the process at its current state, with its RNG seeded by seed; the
+//network is shared with the copy. The macro states and transmission tree
+//are copied only if copy_history is true
+unique_ptr<BaseContagion> BaseContagion::fork(unsigned int seed,
+        bool copy_history) const
+{
+    unique_ptr<BaseContagion> process = clone();
+    if (not process)
+    {
+        throw runtime_error("Forks are not supported by this model");
+    }
+    process->gen_.seed(seed);
+    if (not copy_history)
+    {
+        process->macro_state_vector_.clear();
+        process->transmission_tree_.clear();
+    }
+    return process;
+}
+
+//evolve forks of the process over a period on multiple threads, the fork k
+//using the stream k of an RNG seeded by seed. The process is unchanged.
+//Returns the macro states of each fork, starting with the current one
+vector<vector<MacroState>> BaseContagion::evolve_forks(size_t number_of_forks,
+        double period, unsigned int seed, unsigned int number_of_threads) const
+{
+    if (number_of_threads < 1)
+    {
+        throw invalid_argument("The number of threads must be at least 1");
+    }
+    check_period(period);
+    vector<vector<MacroState>> macro_state_matrix(number_of_forks);
+    number_of_threads = min(size_t(number_of_threads), max(number_of_forks, size_t(1)));
+    parallel_for(number_of_threads, [&](unsigned int thread_index)
+        {
+            for (size_t k = thread_index; k < number_of_forks; k += number_of_threads)
+            {
+                unique_ptr<BaseContagion> process = fork(seed);
+                process->gen_.seed(seed, k);
+                process->evolve(period, false, true);
+                macro_state_matrix[k] = move(process->macro_state_vector_);
+            }
+        });
+    return macro_state_matrix;
+}
+
+//write the state shared by all models on a network
+void BaseContagion::write_state(ostream& stream) const
+{
+    //a summary of the network to check it at loading
+    uint64_t degree_sum = 0;
+    for (Node node = 0; node < network_->size(); node++)
+    {
+        degree_sum += network_->degree(node);
+    }
+    sset::write_binary(stream, uint64_t(network_->size()));
+    sset::write_binary(stream, degree_sum);
+
+    sset::write_binary(stream, current_time_);
+    sset::write_binary(stream, last_event_time_);
+    ostringstream gen_stream;
+    gen_stream << gen_;
+    sset::write_binary_string(stream, gen_stream.str());
+
+    vector<uint8_t> state_vector(state_vector_.begin(), state_vector_.end());
+    sset::write_binary_vector(stream, state_vector);
+
+    //generation of the nodes that can still infect
+    vector<Node> node_vector;
+    vector<Generation> generation_vector;
+    for (const auto& node_generation : infection_generation_)
+    {
+        if (state_vector_[node_generation.first] != R)
+        {
+            node_vector.push_back(node_generation.first);
+            generation_vector.push_back(node_generation.second);
+        }
+    }
+    sset::write_binary_vector(stream, node_vector);
+    sset::write_binary_vector(stream, generation_vector);
+
+    //infected neighbors, in order, of the nodes that have some
+    node_vector.clear();
+    vector<uint64_t> size_vector;
+    vector<Node> neighbor_vector;
+    for (Node node = 0; node < network_->size(); node++)
+    {
+        const vector<Node>& infected_neighbors = infected_neighbors_vector_[node];
+        if (not infected_neighbors.empty())
+        {
+            node_vector.push_back(node);
+            size_vector.push_back(infected_neighbors.size());
+            neighbor_vector.insert(neighbor_vector.end(),
+                    infected_neighbors.begin(), infected_neighbors.end());
+        }
+    }
+    sset::write_binary_vector(stream, node_vector);
+    sset::write_binary_vector(stream, size_vector);
+    sset::write_binary_vector(stream, neighbor_vector);
+}
+
+//read the state written by write_state
+void BaseContagion::read_state(istream& stream)
+{
+    uint64_t degree_sum = 0;
+    for (Node node = 0; node < network_->size(); node++)
+    {
+        degree_sum += network_->degree(node);
+    }
+    if (sset::read_binary<uint64_t>(stream) != network_->size()
+            or sset::read_binary<uint64_t>(stream) != degree_sum)
+    {
+        throw runtime_error("State file was saved on another network");
+    }
+
+    sset::read_binary(stream, current_time_);
+    sset::read_binary(stream, last_event_time_);
+    istringstream gen_stream(sset::read_binary_string(stream));
+    if (not (gen_stream >> gen_))
+    {
+        throw runtime_error("Invalid RNG state in state file");
+    }
+
+    vector<uint8_t> state_vector;
+    sset::read_binary_vector(stream, state_vector);
+    if (state_vector.size() != network_->size())
+    {
+        throw runtime_error("Inconsistent node states in state file");
+    }
+    infected_node_set_.clear();
+    recovered_node_set_.clear();
+    for (Node node = 0; node < network_->size(); node++)
+    {
+        if (state_vector[node] >= COUNT)
+        {
+            throw runtime_error("Inconsistent node states in state file");
+        }
+        state_vector_[node] = NodeState(state_vector[node]);
+        if (state_vector_[node] == I or state_vector_[node] == E)
+        {
+            infected_node_set_.insert(node);
+        }
+        else if (state_vector_[node] == R)
+        {
+            recovered_node_set_.insert(node);
+        }
+    }
+
+    vector<Node> node_vector;
+    vector<Generation> generation_vector;
+    sset::read_binary_vector(stream, node_vector);
+    sset::read_binary_vector(stream, generation_vector);
+    if (node_vector.size() != generation_vector.size())
+    {
+        throw runtime_error("Inconsistent generations in state file");
+    }
+    infection_generation_.clear();
+    for (size_t i = 0; i < node_vector.size(); i++)
+    {
+        if (node_vector[i] >= network_->size())
+        {
+            throw runtime_error("Inconsistent generations in state file");
+        }
+        infection_generation_[node_vector[i]] = generation_vector[i];
+    }
+
+    vector<uint64_t> size_vector;
+    vector<Node> neighbor_vector;
+    sset::read_binary_vector(stream, node_vector);
+    sset::read_binary_vector(stream, size_vector);
+    sset::read_binary_vector(stream, neighbor_vector);
+    if (node_vector.size() != size_vector.size())
+    {
+        throw runtime_error("Inconsistent infected neighbors in state file");
+    }
+    for (Node node = 0; node < network_->size(); node++)
+    {
+        infected_neighbors_vector_[node].clear();
+        infected_neighbor_position_vector_[node].clear();
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < node_vector.size(); i++)
+    {
+        Node node = node_vector[i];
+        if (node >= network_->size() or offset + size_vector[i] > neighbor_vector.size())
+        {
+            throw runtime_error("Inconsistent infected neighbors in state file");
+        }
+        for (size_t position = 0; position < size_vector[i]; position++)
+        {
+            Node neighbor = neighbor_vector[offset + position];
+            if (neighbor >= network_->size())
+            {
+                throw runtime_error("Inconsistent infected neighbors in state file");
+            }
+            infected_neighbors_vector_[node].push_back(neighbor);
+            infected_neighbor_position_vector_[node][neighbor] = position;
+        }
+        offset += size_vector[i];
+    }
+}
+
+//reset the performance counters
+void BaseContagion::reset_performance_counters()
+{
+    performance_counters_ = PerformanceCounters();
 }
 
 }//end of namespace fastsir
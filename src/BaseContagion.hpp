@@ -29,13 +29,20 @@
 #include <unordered_set>
 #include <unordered_map>
 #include "Network.hpp"
+#include "PerformanceCounters.hpp"
+#include <map>
+#include <string>
 #include <iostream>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <limits>
 
 namespace fastsir
 {//start of namespace fastsir
-enum NodeState {S, I, R, COUNT};
+enum NodeState {S, I, R, E, COUNT};
 const unsigned int STATECOUNT = static_cast<unsigned int>(NodeState::COUNT);
-enum Action {RECOVERY,INFECTION};
+enum Action {RECOVERY,INFECTION,ONSET,WANING};
 //enum Actor {GROUP,NODE};
 
 typedef double Time;
@@ -48,6 +55,7 @@ typedef std::pair<Node,Action> Event;
 typedef std::tuple<Time,std::size_t,std::size_t,std::size_t> MacroState;
 typedef std::tuple<Time,Generation,Infector,Infectee,InfectedDegree> Transmission;
 typedef std::unordered_map<Node,std::size_t> InfectedNeighborPosition;
+typedef std::pair<std::vector<double>,double> RateChange; //infection, recovery
 
 
 //abstract class with more functionality to avoid overlapp between classes
@@ -55,21 +63,28 @@ class BaseContagion
 {
 public:
     //Constructor
-    BaseContagion(const EdgeList& edge_list);
+    BaseContagion(const EdgeList& edge_list, bool directed = false);
+    BaseContagion(const BaseContagion& process) = default;
+    BaseContagion(BaseContagion&& process) = default;
+    BaseContagion& operator=(const BaseContagion& process) = default;
+    BaseContagion& operator=(BaseContagion&& process) = default;
+    virtual ~BaseContagion() = default;
 
     //Accessors
-    std::size_t size() const
-        {return network_.size();}
+    virtual std::size_t size() const
+        {return network_->size();}
     const std::vector<NodeState>& get_state_vector() const
         {return state_vector_;}
     const std::unordered_set<Node>& get_infected_node_set() const
         {return infected_node_set_;}
     const Network& get_network() const
-        {return network_;}
+        {return *network_;}
     double get_current_time() const
         {return current_time_;}
-    std::size_t get_number_of_infected_nodes() const
+    virtual std::size_t get_number_of_infected_nodes() const
         {return infected_node_set_.size();}
+    virtual std::size_t get_number_of_recovered_nodes() const
+        {return recovered_node_set_.size();}
     InfectedDegree get_infected_degree(Node node) const
         {return infected_neighbors_vector_.at(node).size();}
     std::vector<MacroState> get_macro_state_vector() const
@@ -78,25 +93,48 @@ public:
         {return transmission_tree_;}
     MacroState get_current_macro_state() const
         {return std::make_tuple(current_time_,
-                                network_.size()-infected_node_set_.size()-recovered_node_set_.size(),
-                                infected_node_set_.size(),
-                                recovered_node_set_.size());}
+                                size()-get_number_of_infected_nodes()-get_number_of_recovered_nodes(),
+                                get_number_of_infected_nodes(),
+                                get_number_of_recovered_nodes());}
+    std::map<std::string,double> get_performance_counters() const;
+    void save_state(const std::string& path, bool save_history = true) const;
+    void save_state(std::ostream& stream, bool save_history = true,
+            bool save_network = false) const;
+    std::unique_ptr<BaseContagion> fork(unsigned int seed,
+            bool copy_history = false) const;
+    std::vector<std::vector<MacroState>> evolve_forks(std::size_t number_of_forks,
+            double period, unsigned int seed, unsigned int number_of_threads = 1) const;
 
     //Mutators
     void seed(unsigned int seed)
         {gen_.seed(seed);}
-    void infect_fraction(double fraction);
-    void infect_node_set(const std::unordered_set<Node>& node_set);
+    virtual void infect_fraction(double fraction);
+    virtual void infect_node_set(const std::unordered_set<Node>& node_set);
 
     virtual void clear();
     void reset();
 
+    virtual void set_infection_rate(const std::vector<double>& infection_rate);
+    virtual void set_recovery_rate(double recovery_rate);
+    void schedule_rates(double time, const std::vector<double>& infection_rate,
+            double recovery_rate = std::numeric_limits<double>::quiet_NaN());
+    void clear_rate_schedule()
+        {rate_schedule_.clear();}
+
     void evolve(double period, bool save_transmission_tree, bool save_macro_state);
+    void reset_performance_counters();
+    void load_state(const std::string& path);
+    void load_state(std::istream& stream);
 
 
 protected:
+    //Constructor without network, for models with no per-node structure
+    BaseContagion();
+    //Constructor provided the network, e.g. a weighted one
+    BaseContagion(std::shared_ptr<const Network> network);
+
     //Members
-    Network network_;
+    std::shared_ptr<const Network> network_; //shared by forks
     std::vector<NodeState> state_vector_;
     std::unordered_set<Node> infected_node_set_;
     std::unordered_set<Node> recovered_node_set_;
@@ -105,23 +143,56 @@ protected:
     std::vector<InfectedNeighborPosition> infected_neighbor_position_vector_;
     std::vector<MacroState> macro_state_vector_;
     std::vector<Transmission> transmission_tree_;
+    std::multimap<double,RateChange> rate_schedule_;
+    PerformanceCounters performance_counters_;
 
     double current_time_;
     double last_event_time_;
-    sset::RNGType &gen_;
+    mutable sset::RNGType gen_; //seeded from the shared RNG at construction
     mutable std::uniform_real_distribution<double> random_01_;
 
     //utility functions
     Node random_infected_neighbor(Node node) const;
     inline void store_current_macro_state();
-    inline void update_transmission_tree(const std::vector<Event>& event_vector);
-    inline void apply_events(const std::vector<Event>& event_vector);
+    virtual void update_transmission_tree(const std::vector<Event>& event_vector);
+    virtual void apply_events(const std::vector<Event>& event_vector);
+    std::vector<Node> get_nodes_at_risk() const;
+    void apply_next_rate_change();
+    //throw if a model cannot take new rates, without changing the process
+    virtual void check_infection_rate(const std::vector<double>& infection_rate) const;
+    virtual void check_recovery_rate(double recovery_rate) const;
+    void check_rate_per_degree(const std::vector<double>& rate_vector) const;
+    //throw if the process cannot evolve over the period
+    virtual void check_period(double) const
+        {}
+    //in discrete time, a change of rates does not move the time steps
+    virtual bool is_discrete_time() const
+        {return false;}
+
+    //state snapshots; a model supports them by naming itself and
+    //extending write_state and read_state with its own members
+    static constexpr std::uint32_t STATE_VERSION = 1;
+    virtual std::string get_model_name() const
+        {return "";}
+    virtual void write_state(std::ostream& stream) const;
+    virtual void read_state(std::istream& stream);
+    void read_snapshot(std::istream& stream);
+
+    //copy of the process, used by fork and load_state; a model supports
+    //them by returning a copy of itself and by moving such a copy into
+    //itself with assign
+    virtual std::unique_ptr<BaseContagion> clone() const
+        {return nullptr;}
+    virtual void assign(BaseContagion&& process)
+        {*this = std::move(process);}
 
     //dummy functions because abstract virtual function breaks binding
     virtual double get_lifetime() const
         {return 1.;}
     virtual void infect(Node node) {};
     virtual void recover(Node node) {};
+    virtual void onset(Node node) {};
+    virtual void wane(Node node) {};
     virtual std::vector<Event> next_step()
         {return std::vector<Event>();}
 
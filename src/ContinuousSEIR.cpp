@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ContinuousSEIR.hpp"
+#include <exception>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+ContinuousSEIR::ContinuousSEIR(const EdgeList& edge_list, double onset_rate,
+        double recovery_rate, const std::vector<double>& infection_rate,
+        bool directed):
+    ContinuousSEIR(make_shared<const Network>(edge_list, directed), onset_rate,
+            recovery_rate, infection_rate)
+{
+}
+
+//constructor of the class provided the network
+ContinuousSEIR::ContinuousSEIR(shared_ptr<const Network> network, double onset_rate,
+        double recovery_rate, const std::vector<double>& infection_rate):
+    ContinuousSIR(move(network), recovery_rate, infection_rate),
+    onset_rate_(onset_rate),
+    onset_event_set_()
+{
+    if (onset_rate <= 0)
+    {
+        throw invalid_argument("Onset rate must be positive");
+    }
+}
+
+//infect a node; it is exposed until the onset of infectiousness
+void ContinuousSEIR::infect(Node node)
+{
+    if (state_vector_[node] == S)
+    {
+        infection_event_set_.erase(node);
+        state_vector_[node] = E;
+        infected_node_set_.insert(node);
+        //create an onset event for the node
+        onset_event_set_.insert(node, 1.);
+        //clear infected neighbors
+        infected_neighbors_vector_[node].clear();
+        infected_neighbor_position_vector_[node].clear();
+    }
+    else
+    {
+        throw runtime_error("Infection attempt: the node is not susceptible");
+    }
+}
+
+//make an exposed node infectious
+void ContinuousSEIR::onset(Node node)
+{
+    if (state_vector_[node] == E)
+    {
+        state_vector_[node] = I;
+        onset_event_set_.erase(node);
+        Event event = make_pair(node,INFECTION);
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
+        {
+            if (state_vector_[neighbor] == S)
+            {
+                update_infection_rate(neighbor, event);
+            }
+        }
+        //create a recovery event for the node
+        recovery_event_set_.insert(node, 1.);
+    }
+    else
+    {
+        throw runtime_error("Onset attempt: the node is not exposed");
+    }
+}
+
+//recover a node; exposed nodes can only be recovered when clearing the state
+void ContinuousSEIR::recover(Node node)
+{
+    if (state_vector_[node] == E)
+    {
+        state_vector_[node] = R;
+        infected_node_set_.erase(node);
+        recovered_node_set_.insert(node);
+        onset_event_set_.erase(node);
+    }
+    else
+    {
+        ContinuousSIR::recover(node);
+    }
+}
+
+//advance the process to the next step by performing infection/onset/recovery
+vector<Event> ContinuousSEIR::next_step()
+{
+    current_time_ = last_event_time_ + get_lifetime();
+    last_event_time_ = current_time_;
+    vector<Event> event_vector;
+
+    //determine the type of the next event
+    double infection_rate = infection_event_set_.total_weight();
+    double onset_rate = onset_rate_*onset_event_set_.total_weight();
+    double r = random_01_(gen_)*get_total_rate();
+    if (r < infection_rate)
+    {
+        Node node = (infection_event_set_.sample_ext_RNG(gen_)).value().first;
+        event_vector.emplace_back(node,INFECTION);
+    }
+    else if (r < infection_rate + onset_rate)
+    {
+        Node node = (onset_event_set_.sample_ext_RNG(gen_)).value().first;
+        event_vector.emplace_back(node,ONSET);
+    }
+    else
+    {
+        Node node = (recovery_event_set_.sample_ext_RNG(gen_)).value().first;
+        event_vector.emplace_back(node,RECOVERY);
+    }
+
+    return event_vector;
+}
+
+//clear the state; as if all node became susceptible at this time
+//clear all measures as well
+//overload ContinuousSIR
+void ContinuousSEIR::clear()
+{
+    ContinuousSIR::clear();
+    onset_event_set_.clear();
+}
+
+//write the onset parameter and event set after the SIR state
+void ContinuousSEIR::write_state(ostream& stream) const
+{
+    ContinuousSIR::write_state(stream);
+    sset::write_binary(stream, onset_rate_);
+    onset_event_set_.save(stream);
+}
+
+//read the state written by write_state
+void ContinuousSEIR::read_state(istream& stream)
+{
+    ContinuousSIR::read_state(stream);
+    sset::read_binary(stream, onset_rate_);
+    onset_event_set_.load(stream);
+}
+
+}//end of namespace fastsir
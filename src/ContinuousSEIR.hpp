@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTINUOUSSEIR_HPP_
+#define CONTINUOUSSEIR_HPP_
+
+#include "ContinuousSIR.hpp"
+
+namespace fastsir
+{//start of namespace fastsir
+
+
+//class to simulate SEIR process on networks; infected nodes are exposed (E)
+//before becoming infectious and are counted as infected in the macro states.
+//Tau-leaping is not available for this model
+class ContinuousSEIR : public ContinuousSIR
+{
+public:
+    //Constructor
+    ContinuousSEIR(const EdgeList& edge_list, double onset_rate,
+                   double recovery_rate, const std::vector<double>& infection_rate,
+                   bool directed = false);
+    ContinuousSEIR(std::shared_ptr<const Network> network, double onset_rate,
+                   double recovery_rate, const std::vector<double>& infection_rate);
+
+    //Accessors
+    double get_lifetime() const
+        {return infected_node_set_.size() == 0 ?
+            std::numeric_limits<double>::infinity() : 1./get_total_rate();}
+    std::size_t get_number_of_exposed_nodes() const
+        {return onset_event_set_.size();}
+
+    //Mutators
+    void clear();
+
+protected:
+    //Members
+    double onset_rate_;
+    sset::UniformSet<Node> onset_event_set_;
+
+    //utility functions
+    inline double get_total_rate() const
+        {return ContinuousSIR::get_total_rate()
+            + onset_rate_*onset_event_set_.total_weight();}
+
+    void infect(Node node);
+    void onset(Node node);
+    void recover(Node node);
+    std::vector<Event> next_step();
+
+    std::string get_model_name() const
+        {return "ContinuousSEIR";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<ContinuousSEIR>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<ContinuousSEIR&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
+};
+
+}//end of namespace fastsir
+
+#endif /* CONTINUOUSSEIR_HPP_ */
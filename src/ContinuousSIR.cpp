@@ -37,32 +37,101 @@ namespace fastsir
 
 //constructor of the class
 ContinuousSIR::ContinuousSIR(const EdgeList& edge_list, double recovery_rate,
-        const std::vector<double>& infection_rate):
-    BaseContagion(edge_list),
+        const std::vector<double>& infection_rate, bool directed):
+    ContinuousSIR(make_shared<const Network>(edge_list, directed), recovery_rate,
+            infection_rate)
+{
+}
+
+//constructor of the class provided the network
+ContinuousSIR::ContinuousSIR(shared_ptr<const Network> network,
+        double recovery_rate, const std::vector<double>& infection_rate):
+    BaseContagion(move(network)),
     recovery_rate_(recovery_rate),
     infection_rate_(infection_rate),
-    infection_event_set_(1.,1.),
-    recovery_event_set_(1.,1.)
+    infection_event_set_(),
+    recovery_event_set_(),
+    tau_leaping_error_(0.),
+    tau_leaping_minimum_infected_(0),
+    poisson_dist_(1.)
 {
-    //calculate Poisson rate equivalent for each rate
-    double min = std::numeric_limits<double>::infinity();
-    double max = 0;
-    for (double rate : infection_rate)
+}
+
+//enable tau-leaping; the error parameter bounds the expected relative change
+//of the number of susceptible and infected nodes during a leap. Exact steps
+//are performed when fewer than minimum_infected nodes are infected.
+//An error of 0 disables tau-leaping.
+void ContinuousSIR::set_tau_leaping(double error, size_t minimum_infected)
+{
+    if (error < 0 or error >= 1)
     {
-        if (rate > max)
-        {
-            max = rate;
-        }
-        if (rate < min and rate > 0)
+        throw invalid_argument("Tau-leaping error must be in [0,1)");
+    }
+    tau_leaping_error_ = error;
+    tau_leaping_minimum_infected_ = minimum_infected;
+}
+
+//set new infection rates; the event set is rebuilt in a single pass over
+//the susceptible nodes with infected neighbors
+void ContinuousSIR::set_infection_rate(const vector<double>& infection_rate)
+{
+    check_infection_rate(infection_rate);
+    infection_rate_ = infection_rate;
+    vector<pair<Node,double>> element_weight_vector;
+    for (Node node : get_nodes_at_risk())
+    {
+        double rate = get_infection_rate(node);
+        if (rate > 0)
         {
-            min = rate;
+            element_weight_vector.emplace_back(node, rate);
         }
     }
-    infection_event_set_ = sset::SamplableSet<Node>(min,max); //set true bounds
+    infection_event_set_.assign(element_weight_vector);
+}
+
+//set a new recovery rate; it is common to all infected nodes
+void ContinuousSIR::set_recovery_rate(double recovery_rate)
+{
+    check_recovery_rate(recovery_rate);
+    recovery_rate_ = recovery_rate;
+}
+
+void ContinuousSIR::check_recovery_rate(double recovery_rate) const
+{
+    if (recovery_rate < 0)
+    {
+        throw invalid_argument("Recovery rate must be non-negative");
+    }
+}
+
+//get the largest leap compatible with the error parameter
+//(Cao, Gillespie and Petzold, J. Chem. Phys. 124, 044109 (2006))
+double ContinuousSIR::get_leap_time() const
+{
+    double infection_rate = infection_event_set_.total_weight();
+    double recovery_rate = recovery_rate_*recovery_event_set_.total_weight();
+    double number_of_infected = infected_node_set_.size();
+    double number_of_susceptible = size() - number_of_infected
+        - recovered_node_set_.size();
+
+    //infected nodes: drift and variance of the change
+    double bound = max(tau_leaping_error_*number_of_infected, 1.);
+    double tau = bound*bound/(infection_rate + recovery_rate);
+    if (infection_rate != recovery_rate)
+    {
+        tau = min(tau, bound/abs(infection_rate - recovery_rate));
+    }
+    //susceptible nodes
+    if (infection_rate > 0)
+    {
+        bound = max(tau_leaping_error_*number_of_susceptible, 1.);
+        tau = min(tau, bound/infection_rate);
+    }
+    return tau;
 }
 
 //update the infection rate of a neighbor node
-inline void ContinuousSIR::update_infection_rate(Node node, const Event& event)
+void ContinuousSIR::update_infection_rate(Node node, const Event& event)
 {
     Node other_node = event.first;
     Action action = event.second;
@@ -104,8 +173,34 @@ inline void ContinuousSIR::update_infection_rate(Node node, const Event& event)
     }
 }
 
+//list the infected neighbors of a node that becomes susceptible again, as
+//they are not followed while it is not susceptible, and set its infection
+//rate; in a directed network, these are the in-neighbors
+void ContinuousSIR::list_infected_neighbors(Node node)
+{
+    vector<Node>& infected_neighbors = infected_neighbors_vector_[node];
+    InfectedNeighborPosition& infected_neighbor_position =
+        infected_neighbor_position_vector_[node];
+    infected_neighbors.clear();
+    infected_neighbor_position.clear();
+    FASTSIR_PROFILE_ADD(neighbor_visits, network_->in_degree(node));
+    for (Node neighbor : network_->in_adjacent_nodes(node))
+    {
+        if (state_vector_[neighbor] == I)
+        {
+            infected_neighbor_position[neighbor] = infected_neighbors.size();
+            infected_neighbors.push_back(neighbor);
+        }
+    }
+    double rate = get_infection_rate(node);
+    if (not infected_neighbors.empty() and rate > 0)
+    {
+        infection_event_set_.insert(node, rate);
+    }
+}
+
 //infect a node
-inline void ContinuousSIR::infect(Node node)
+void ContinuousSIR::infect(Node node)
 {
     if (state_vector_[node] == S)
     {
@@ -113,7 +208,8 @@ inline void ContinuousSIR::infect(Node node)
         state_vector_[node] = I;
         infected_node_set_.insert(node);
         Event event = make_pair(node,INFECTION);
-        for (Node neighbor : network_.adjacent_nodes(node))
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
         {
             if (state_vector_[neighbor] == S)
             {
@@ -133,7 +229,7 @@ inline void ContinuousSIR::infect(Node node)
 }
 
 //recover a node
-inline void ContinuousSIR::recover(Node node)
+void ContinuousSIR::recover(Node node)
 {
     if (state_vector_[node] == I)
     {
@@ -141,7 +237,8 @@ inline void ContinuousSIR::recover(Node node)
         infected_node_set_.erase(node);
         recovered_node_set_.insert(node);
         Event event = make_pair(node,RECOVERY);
-        for (Node neighbor : network_.adjacent_nodes(node))
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
         {
             if (state_vector_[neighbor] == S)
             {
@@ -159,8 +256,12 @@ inline void ContinuousSIR::recover(Node node)
 
 
 //advance the process to the next step by performing infection/recovery
-inline vector<Event> ContinuousSIR::next_step()
+vector<Event> ContinuousSIR::next_step()
 {
+    if (is_leaping())
+    {
+        return next_leap();
+    }
     current_time_ = last_event_time_ + get_lifetime();
     last_event_time_ = current_time_;
     vector<Event> event_vector;
@@ -169,13 +270,13 @@ inline vector<Event> ContinuousSIR::next_step()
     if ((infection_event_set_.total_weight()/get_total_rate()) > random_01_(gen_))
     {
         //infection event
-        Node node = (infection_event_set_.sample()).value().first;
+        Node node = (infection_event_set_.sample_ext_RNG(gen_)).value().first;
         event_vector.emplace_back(node,INFECTION);
     }
     else
     {
         //recovery event
-        Node node = (recovery_event_set_.sample()).value().first;
+        Node node = (recovery_event_set_.sample_ext_RNG(gen_)).value().first;
         event_vector.emplace_back(node,RECOVERY);
     }
 
@@ -183,14 +284,79 @@ inline vector<Event> ContinuousSIR::next_step()
 }
 
 
+//advance the process by a leap with the rates of the current state; a
+//Poisson number of infected nodes recover, and each node at risk is
+//infected independently with probability 1-exp(-rate*tau)
+inline vector<Event> ContinuousSIR::next_leap()
+{
+    double tau = get_leap_time();
+    current_time_ = last_event_time_ + tau;
+    last_event_time_ = current_time_;
+
+    //get the number of recoveries and assign them to distinct nodes
+    int nb_rec = 0;
+    if (recovery_event_set_.total_weight() > 0)
+    {
+        poisson_dist_ = poisson_distribution<int>(
+                recovery_rate_*recovery_event_set_.total_weight()*tau);
+        nb_rec = poisson_dist_(gen_);
+    }
+    vector<Node> new_recovered;
+    recovery_event_set_.sample_n_without_replacement_ext_RNG(nb_rec, new_recovered,
+            gen_);
+
+    //a node can only be infected once, so infections are not drawn with
+    //replacement
+    vector<Node> new_infected;
+    infection_event_set_.sample_independent_ext_RNG(
+            [tau](double rate) {return -expm1(-rate*tau);}, new_infected, gen_);
+
+    //return vector of events
+    vector<Event> event_vector;
+    for (Node node : new_recovered)
+    {
+        event_vector.emplace_back(node,RECOVERY);
+    }
+    for (Node node : new_infected)
+    {
+        event_vector.emplace_back(node,INFECTION);
+    }
+    return event_vector;
+}
+
+
 //clear the state; as if all node became susceptible at this time
 //clear all measures as well
 //overload BaseContagion
 void ContinuousSIR::clear()
 {
     BaseContagion::clear();
-    infection_event_set_.clear(); //to avoid numerical error accumulation
-    recovery_event_set_.clear(); //to avoid numerical error accumulation
+    infection_event_set_.clear();
+    recovery_event_set_.clear();
+}
+
+//write the parameters and event sets after the common state
+void ContinuousSIR::write_state(ostream& stream) const
+{
+    BaseContagion::write_state(stream);
+    sset::write_binary(stream, recovery_rate_);
+    sset::write_binary_vector(stream, infection_rate_);
+    sset::write_binary(stream, tau_leaping_error_);
+    sset::write_binary(stream, uint64_t(tau_leaping_minimum_infected_));
+    infection_event_set_.save(stream);
+    recovery_event_set_.save(stream);
+}
+
+//read the state written by write_state
+void ContinuousSIR::read_state(istream& stream)
+{
+    BaseContagion::read_state(stream);
+    sset::read_binary(stream, recovery_rate_);
+    sset::read_binary_vector(stream, infection_rate_);
+    sset::read_binary(stream, tau_leaping_error_);
+    tau_leaping_minimum_infected_ = sset::read_binary<uint64_t>(stream);
+    infection_event_set_.load(stream);
+    recovery_event_set_.load(stream);
 }
 
 
@@ -26,6 +26,7 @@
 #define CONTINUOUSSIR_HPP_
 
 #include "BaseContagion.hpp"
+#include "SamplableSet/UniformSet.hpp"
 
 namespace fastsir
 {//start of namespace fastsir
@@ -37,14 +38,24 @@ class ContinuousSIR : public BaseContagion
 public:
     //Constructor
     ContinuousSIR(const EdgeList& edge_list, double recovery_rate,
+                  const std::vector<double>& infection_rate,
+                  bool directed = false);
+    //Constructor provided the network, which can be shared with other processes
+    ContinuousSIR(std::shared_ptr<const Network> network, double recovery_rate,
                   const std::vector<double>& infection_rate);
 
     //Accessors
     double get_lifetime() const
         {return infected_node_set_.size() == 0 ?
-            std::numeric_limits<double>::infinity() : 1./(get_total_rate());}
+            std::numeric_limits<double>::infinity() :
+            (is_leaping() ? get_leap_time() : 1./(get_total_rate()));}
+    double get_tau_leaping_error() const
+        {return tau_leaping_error_;}
 
     //Mutators
+    void set_tau_leaping(double error, std::size_t minimum_infected = 100);
+    void set_infection_rate(const std::vector<double>& infection_rate);
+    void set_recovery_rate(double recovery_rate);
     void clear();
 
 protected:
@@ -52,7 +63,10 @@ protected:
     double recovery_rate_;
     std::vector<double> infection_rate_;
     sset::SamplableSet<Node> infection_event_set_;
-    sset::SamplableSet<Node> recovery_event_set_;
+    sset::UniformSet<Node> recovery_event_set_;
+    double tau_leaping_error_; //0 for exact simulation
+    std::size_t tau_leaping_minimum_infected_;
+    std::poisson_distribution<int> poisson_dist_;
 
     //utility functions
     inline double get_infection_rate(Node node) const
@@ -60,11 +74,35 @@ protected:
     inline double get_total_rate() const
         {return infection_event_set_.total_weight() + recovery_rate_*recovery_event_set_.total_weight();}
 
-    inline void update_infection_rate(Node node, const Event& event);
+    double get_leap_time() const;
+    inline bool is_leaping() const
+        {return tau_leaping_error_ > 0 and
+            infected_node_set_.size() >= tau_leaping_minimum_infected_ and
+            get_leap_time()*get_total_rate() >= MINIMUM_EVENTS_PER_LEAP;}
 
-    inline void infect(Node node);
-    inline void recover(Node node);
-    inline std::vector<Event> next_step();
+    void update_infection_rate(Node node, const Event& event);
+    void list_infected_neighbors(Node node);
+    void check_infection_rate(const std::vector<double>& infection_rate) const
+        {check_rate_per_degree(infection_rate);}
+    void check_recovery_rate(double recovery_rate) const;
+
+    void infect(Node node);
+    void recover(Node node);
+    std::vector<Event> next_step();
+    inline std::vector<Event> next_leap();
+
+    std::string get_model_name() const
+        {return "ContinuousSIR";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<ContinuousSIR>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<ContinuousSIR&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
+
+    //a leap must contain this many events on average, otherwise exact
+    //steps are cheaper
+    static constexpr double MINIMUM_EVENTS_PER_LEAP = 10.;
 };
 
 }//end of namespace fastsir
@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ContinuousSIRS.hpp"
+#include <exception>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+ContinuousSIRS::ContinuousSIRS(const EdgeList& edge_list, double recovery_rate,
+        double waning_rate, const std::vector<double>& infection_rate,
+        bool directed):
+    ContinuousSIRS(make_shared<const Network>(edge_list, directed), recovery_rate,
+            waning_rate, infection_rate)
+{
+}
+
+//constructor of the class provided the network
+ContinuousSIRS::ContinuousSIRS(shared_ptr<const Network> network, double recovery_rate,
+        double waning_rate, const std::vector<double>& infection_rate):
+    ContinuousSIR(move(network), recovery_rate, infection_rate),
+    waning_rate_(waning_rate),
+    waning_event_set_()
+{
+    if (waning_rate < 0)
+    {
+        throw invalid_argument("Waning rate must be non-negative");
+    }
+}
+
+//recover a node; its immunity then wanes
+void ContinuousSIRS::recover(Node node)
+{
+    ContinuousSIR::recover(node);
+    waning_event_set_.insert(node, 1.);
+}
+
+//make a recovered node susceptible again
+void ContinuousSIRS::wane(Node node)
+{
+    if (state_vector_[node] == R)
+    {
+        state_vector_[node] = S;
+        recovered_node_set_.erase(node);
+        infection_generation_.erase(node);
+        waning_event_set_.erase(node);
+        list_infected_neighbors(node);
+    }
+    else
+    {
+        throw runtime_error("Waning attempt: the node is not recovered");
+    }
+}
+
+//advance the process to the next step by performing infection/recovery/waning
+vector<Event> ContinuousSIRS::next_step()
+{
+    current_time_ = last_event_time_ + get_lifetime();
+    last_event_time_ = current_time_;
+    vector<Event> event_vector;
+
+    //determine the type of the next event
+    double infection_rate = infection_event_set_.total_weight();
+    double recovery_rate = recovery_rate_*recovery_event_set_.total_weight();
+    double r = random_01_(gen_)*get_total_rate();
+    if (r < infection_rate)
+    {
+        Node node = (infection_event_set_.sample_ext_RNG(gen_)).value().first;
+        event_vector.emplace_back(node,INFECTION);
+    }
+    else if (r < infection_rate + recovery_rate)
+    {
+        Node node = (recovery_event_set_.sample_ext_RNG(gen_)).value().first;
+        event_vector.emplace_back(node,RECOVERY);
+    }
+    else
+    {
+        Node node = (waning_event_set_.sample_ext_RNG(gen_)).value().first;
+        event_vector.emplace_back(node,WANING);
+    }
+
+    return event_vector;
+}
+
+//clear the state; as if all node became susceptible at this time
+//clear all measures as well
+//overload ContinuousSIR
+void ContinuousSIRS::clear()
+{
+    ContinuousSIR::clear();
+    waning_event_set_.clear();
+}
+
+//write the waning parameter and event set after the SIR state
+void ContinuousSIRS::write_state(ostream& stream) const
+{
+    ContinuousSIR::write_state(stream);
+    sset::write_binary(stream, waning_rate_);
+    waning_event_set_.save(stream);
+}
+
+//read the state written by write_state
+void ContinuousSIRS::read_state(istream& stream)
+{
+    ContinuousSIR::read_state(stream);
+    sset::read_binary(stream, waning_rate_);
+    waning_event_set_.load(stream);
+}
+
+}//end of namespace fastsir
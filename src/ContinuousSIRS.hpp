@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTINUOUSSIRS_HPP_
+#define CONTINUOUSSIRS_HPP_
+
+#include "ContinuousSIR.hpp"
+
+namespace fastsir
+{//start of namespace fastsir
+
+
+//class to simulate SIRS process on networks; recovered nodes lose their
+//immunity and become susceptible again. The process stops when no node is
+//infected. Tau-leaping is not available for this model
+class ContinuousSIRS : public ContinuousSIR
+{
+public:
+    //Constructor
+    ContinuousSIRS(const EdgeList& edge_list, double recovery_rate,
+                   double waning_rate, const std::vector<double>& infection_rate,
+                   bool directed = false);
+    ContinuousSIRS(std::shared_ptr<const Network> network, double recovery_rate,
+                   double waning_rate, const std::vector<double>& infection_rate);
+
+    //Accessors
+    double get_lifetime() const
+        {return infected_node_set_.size() == 0 ?
+            std::numeric_limits<double>::infinity() : 1./get_total_rate();}
+
+    //Mutators
+    void clear();
+
+protected:
+    //Members
+    double waning_rate_;
+    sset::UniformSet<Node> waning_event_set_;
+
+    //utility functions
+    inline double get_total_rate() const
+        {return ContinuousSIR::get_total_rate()
+            + waning_rate_*waning_event_set_.total_weight();}
+
+    void recover(Node node);
+    void wane(Node node);
+    std::vector<Event> next_step();
+
+    std::string get_model_name() const
+        {return "ContinuousSIRS";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<ContinuousSIRS>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<ContinuousSIRS&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
+};
+
+}//end of namespace fastsir
+
+#endif /* CONTINUOUSSIRS_HPP_ */
@@ -0,0 +1,261 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ContinuousSIS.hpp"
+#include <algorithm>
+#include <exception>
+#include <cmath>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+ContinuousSIS::ContinuousSIS(const EdgeList& edge_list, double recovery_rate,
+        const std::vector<double>& infection_rate, bool directed):
+    ContinuousSIS(make_shared<const Network>(edge_list, directed), recovery_rate,
+            infection_rate)
+{
+}
+
+//constructor of the class provided the network
+ContinuousSIS::ContinuousSIS(shared_ptr<const Network> network, double recovery_rate,
+        const std::vector<double>& infection_rate):
+    ContinuousSIR(move(network), recovery_rate, infection_rate),
+    reservoir_size_(0),
+    snapshot_period_(1.),
+    next_snapshot_time_(0.),
+    reservoir_(),
+    time_histogram_(),
+    histogram_time_(0.)
+{
+}
+
+//enable the quasi-stationary method with a reservoir of reservoir_size
+//configurations; a configuration is stored every snapshot period, in place
+//of a random one once the reservoir is full. A size of 0 disables it.
+//The quasi-stationary distribution is measured from now on
+void ContinuousSIS::set_quasistationary(size_t reservoir_size, double snapshot_period)
+{
+    if (snapshot_period <= 0)
+    {
+        throw invalid_argument("Snapshot period must be positive");
+    }
+    reservoir_size_ = reservoir_size;
+    snapshot_period_ = snapshot_period;
+    next_snapshot_time_ = current_time_;
+    reservoir_.clear();
+    time_histogram_.assign(reservoir_size > 0 ? size() + 1 : 0, 0.);
+    histogram_time_ = current_time_;
+}
+
+//get the fraction of time spent with each number of infected nodes since
+//the quasi-stationary method was enabled
+vector<double> ContinuousSIS::get_quasistationary_distribution() const
+{
+    vector<double> distribution = time_histogram_;
+    double total_time = 0.;
+    for (double time : time_histogram_)
+    {
+        total_time += time;
+    }
+    if (total_time > 0)
+    {
+        for (double& probability : distribution)
+        {
+            probability /= total_time;
+        }
+    }
+    return distribution;
+}
+
+//recover a node; it is susceptible again
+void ContinuousSIS::recover(Node node)
+{
+    if (state_vector_[node] == I)
+    {
+        state_vector_[node] = S;
+        infected_node_set_.erase(node);
+        infection_generation_.erase(node);
+        Event event = make_pair(node,RECOVERY);
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
+        {
+            if (state_vector_[neighbor] == S)
+            {
+                update_infection_rate(neighbor, event);
+            }
+        }
+        //erase the recovery event for the node
+        recovery_event_set_.erase(node);
+        list_infected_neighbors(node);
+    }
+    else
+    {
+        throw runtime_error("Recovery attempt: the node is not infected");
+    }
+}
+
+//advance the process to the next step; the time since the last step is
+//added to the quasi-stationary distribution
+vector<Event> ContinuousSIS::next_step()
+{
+    size_t number_of_infected = infected_node_set_.size();
+    vector<Event> event_vector = ContinuousSIR::next_step();
+    if (not time_histogram_.empty() and current_time_ > histogram_time_)
+    {
+        time_histogram_[number_of_infected] += current_time_ - histogram_time_;
+        histogram_time_ = current_time_;
+    }
+    return event_vector;
+}
+
+//apply the events of a step; with the quasi-stationary method, the
+//absorbing state is replaced by a configuration of the reservoir
+void ContinuousSIS::apply_events(const vector<Event>& event_vector)
+{
+    BaseContagion::apply_events(event_vector);
+    if (reservoir_size_ > 0)
+    {
+        if (infected_node_set_.empty())
+        {
+            restore_configuration();
+        }
+        else if (current_time_ >= next_snapshot_time_)
+        {
+            store_configuration();
+            next_snapshot_time_ = current_time_ + snapshot_period_;
+        }
+    }
+}
+
+//with the quasi-stationary method, the process never reaches the absorbing
+//state, so it cannot evolve until no event is left
+void ContinuousSIS::check_period(double period) const
+{
+    if (reservoir_size_ > 0 and not isfinite(period))
+    {
+        throw invalid_argument("The period must be finite with the quasi-stationary method");
+    }
+}
+
+//store the current configuration in the reservoir
+void ContinuousSIS::store_configuration()
+{
+    vector<Node> configuration(infected_node_set_.begin(), infected_node_set_.end());
+    sort(configuration.begin(), configuration.end());
+    if (reservoir_.size() < reservoir_size_)
+    {
+        reservoir_.push_back(move(configuration));
+    }
+    else
+    {
+        uniform_int_distribution<size_t> random_index(0, reservoir_.size() - 1);
+        reservoir_[random_index(gen_)] = move(configuration);
+    }
+}
+
+//infect the nodes of a random configuration of the reservoir; the process
+//stops as usual if the reservoir is still empty
+void ContinuousSIS::restore_configuration()
+{
+    if (reservoir_.empty())
+    {
+        return;
+    }
+    uniform_int_distribution<size_t> random_index(0, reservoir_.size() - 1);
+    for (Node node : reservoir_[random_index(gen_)])
+    {
+        infect(node);
+        infection_generation_[node] = 0;
+    }
+}
+
+//clear the state; as if all node became susceptible at this time
+//clear all measures as well, including the reservoir
+//overload ContinuousSIR
+void ContinuousSIS::clear()
+{
+    ContinuousSIR::clear();
+    reservoir_.clear();
+    next_snapshot_time_ = current_time_;
+    fill(time_histogram_.begin(), time_histogram_.end(), 0.);
+    histogram_time_ = current_time_;
+}
+
+//write the quasi-stationary method after the SIR state
+void ContinuousSIS::write_state(ostream& stream) const
+{
+    ContinuousSIR::write_state(stream);
+    sset::write_binary(stream, uint64_t(reservoir_size_));
+    sset::write_binary(stream, snapshot_period_);
+    sset::write_binary(stream, next_snapshot_time_);
+    sset::write_binary(stream, histogram_time_);
+    sset::write_binary_vector(stream, time_histogram_);
+    vector<uint64_t> size_vector;
+    vector<Node> node_vector;
+    for (const vector<Node>& configuration : reservoir_)
+    {
+        size_vector.push_back(configuration.size());
+        node_vector.insert(node_vector.end(), configuration.begin(),
+                configuration.end());
+    }
+    sset::write_binary_vector(stream, size_vector);
+    sset::write_binary_vector(stream, node_vector);
+}
+
+//read the state written by write_state
+void ContinuousSIS::read_state(istream& stream)
+{
+    ContinuousSIR::read_state(stream);
+    reservoir_size_ = sset::read_binary<uint64_t>(stream);
+    sset::read_binary(stream, snapshot_period_);
+    sset::read_binary(stream, next_snapshot_time_);
+    sset::read_binary(stream, histogram_time_);
+    sset::read_binary_vector(stream, time_histogram_);
+    vector<uint64_t> size_vector;
+    vector<Node> node_vector;
+    sset::read_binary_vector(stream, size_vector);
+    sset::read_binary_vector(stream, node_vector);
+    reservoir_.clear();
+    size_t offset = 0;
+    for (uint64_t configuration_size : size_vector)
+    {
+        if (offset + configuration_size > node_vector.size())
+        {
+            throw runtime_error("Inconsistent reservoir in state file");
+        }
+        reservoir_.emplace_back(node_vector.begin() + offset,
+                node_vector.begin() + offset + configuration_size);
+        offset += configuration_size;
+    }
+    if (reservoir_.size() > reservoir_size_
+            or (not time_histogram_.empty() and time_histogram_.size() != size() + 1))
+    {
+        throw runtime_error("Inconsistent reservoir in state file");
+    }
+}
+
+}//end of namespace fastsir
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTINUOUSSIS_HPP_
+#define CONTINUOUSSIS_HPP_
+
+#include "ContinuousSIR.hpp"
+
+namespace fastsir
+{//start of namespace fastsir
+
+
+//class to simulate SIS process on networks; recovered nodes are susceptible
+//again. With the quasi-stationary method, the process is restored to a past
+//configuration from a reservoir when no node is infected, so it never stops
+//(de Oliveira and Dickman, Phys. Rev. E 71, 016129 (2005))
+class ContinuousSIS : public ContinuousSIR
+{
+public:
+    //Constructor
+    ContinuousSIS(const EdgeList& edge_list, double recovery_rate,
+                  const std::vector<double>& infection_rate,
+                  bool directed = false);
+    ContinuousSIS(std::shared_ptr<const Network> network, double recovery_rate,
+                  const std::vector<double>& infection_rate);
+
+    //Accessors
+    std::size_t get_reservoir_size() const
+        {return reservoir_size_;}
+    std::vector<double> get_quasistationary_distribution() const;
+
+    //Mutators
+    void set_quasistationary(std::size_t reservoir_size, double snapshot_period = 1.);
+    void clear();
+
+protected:
+    //Members
+    std::size_t reservoir_size_; //0 without the quasi-stationary method
+    double snapshot_period_;
+    double next_snapshot_time_;
+    std::vector<std::vector<Node>> reservoir_; //infected nodes, in order
+    std::vector<double> time_histogram_; //time spent per number of infected
+    double histogram_time_; //time up to which the histogram is filled
+
+    //utility functions
+    void recover(Node node);
+    std::vector<Event> next_step();
+    void apply_events(const std::vector<Event>& event_vector);
+    void store_configuration();
+    void restore_configuration();
+    void check_period(double period) const;
+
+    std::string get_model_name() const
+        {return "ContinuousSIS";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<ContinuousSIS>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<ContinuousSIS&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
+};
+
+}//end of namespace fastsir
+
+#endif /* CONTINUOUSSIS_HPP_ */
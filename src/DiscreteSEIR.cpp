@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DiscreteSEIR.hpp"
+#include "Parallel.hpp"
+#include <cmath>
+#include <exception>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+DiscreteSEIR::DiscreteSEIR(const EdgeList& edge_list, double onset_probability,
+        double recovery_probability, const std::vector<double>& infection_probability,
+        bool directed):
+    DiscreteSEIR(make_shared<const Network>(edge_list, directed), onset_probability,
+            recovery_probability, infection_probability)
+{
+}
+
+//constructor of the class provided the network
+DiscreteSEIR::DiscreteSEIR(shared_ptr<const Network> network, double onset_probability,
+        double recovery_probability, const std::vector<double>& infection_probability):
+    DiscreteSIR(move(network), recovery_probability, infection_probability),
+    onset_probability_(onset_probability),
+    onset_event_set_()
+{
+    if (onset_probability <= 0 or onset_probability > 1)
+    {
+        throw invalid_argument("Onset probability must be in (0,1]");
+    }
+}
+
+//infect a node; it is exposed until the onset of infectiousness
+void DiscreteSEIR::infect(Node node)
+{
+    if (state_vector_[node] == S)
+    {
+        infection_event_set_.erase(node);
+        state_vector_[node] = E;
+        infected_node_set_.insert(node);
+        //create an onset event for the node
+        onset_event_set_.insert(node, 1.);
+        //clear infected neighbors
+        infected_neighbors_vector_[node].clear();
+        infected_neighbor_position_vector_[node].clear();
+    }
+    else
+    {
+        throw runtime_error("Infection attempt: the node is not susceptible");
+    }
+}
+
+//make an exposed node infectious
+void DiscreteSEIR::onset(Node node)
+{
+    if (state_vector_[node] == E)
+    {
+        state_vector_[node] = I;
+        onset_event_set_.erase(node);
+        Event event = make_pair(node,INFECTION);
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
+        {
+            if (state_vector_[neighbor] == S)
+            {
+                update_infected_neighbors(neighbor, event);
+                update_infection_propensity(neighbor);
+            }
+        }
+        //create a recovery event for the node
+        recovery_event_set_.insert(node, 1.);
+    }
+    else
+    {
+        throw runtime_error("Onset attempt: the node is not exposed");
+    }
+}
+
+//recover a node; exposed nodes can only be recovered when clearing the state
+void DiscreteSEIR::recover(Node node)
+{
+    if (state_vector_[node] == E)
+    {
+        state_vector_[node] = R;
+        infected_node_set_.erase(node);
+        recovered_node_set_.insert(node);
+        onset_event_set_.erase(node);
+    }
+    else
+    {
+        DiscreteSIR::recover(node);
+    }
+}
+
+//advance the process to the next step by performing infection/onset/recovery
+//each infected node recovers with the recovery probability, each exposed node
+//becomes infectious with the onset probability and each susceptible node is
+//infected with the probability of its infected degree, independently
+vector<Event> DiscreteSEIR::next_step()
+{
+    current_time_ = last_event_time_ + get_lifetime();
+    last_event_time_ = current_time_;
+
+    double recovery_probability = recovery_probability_;
+    auto recovery_func = [recovery_probability](double)
+        {return recovery_probability;};
+    double onset_probability = onset_probability_;
+    auto onset_func = [onset_probability](double)
+        {return onset_probability;};
+    //the propensity is the Poisson rate equivalent
+    auto infection_func = [](double propensity)
+        {return -expm1(-propensity);};
+
+    //decisions only depend on the current state; each thread visits a part of
+    //the event sets with its own RNG stream
+    unsigned int number_of_threads = min(number_of_threads_, unsigned(
+            (recovery_event_set_.size() + onset_event_set_.size()
+             + infection_event_set_.size())/MINIMUM_EVENTS_PER_THREAD + 1));
+    vector<vector<Node>> new_recovered(number_of_threads);
+    vector<vector<Node>> new_onset(number_of_threads);
+    vector<vector<Node>> new_infected(number_of_threads);
+    if (number_of_threads == 1)
+    {
+        recovery_event_set_.sample_independent_ext_RNG(recovery_func,
+                new_recovered[0], gen_);
+        onset_event_set_.sample_independent_ext_RNG(onset_func,
+                new_onset[0], gen_);
+        infection_event_set_.sample_independent_ext_RNG(infection_func,
+                new_infected[0], gen_);
+    }
+    else
+    {
+        uint64_t stream_seed = (uint64_t(gen_()) << 32) | gen_();
+        parallel_for(number_of_threads, [&](unsigned int thread_index)
+            {
+                sset::RNGType gen(stream_seed, thread_index);
+                recovery_event_set_.sample_independent_ext_RNG(recovery_func,
+                        new_recovered[thread_index], gen, thread_index,
+                        number_of_threads);
+                onset_event_set_.sample_independent_ext_RNG(onset_func,
+                        new_onset[thread_index], gen, thread_index,
+                        number_of_threads);
+                infection_event_set_.sample_independent_ext_RNG(infection_func,
+                        new_infected[thread_index], gen, thread_index,
+                        number_of_threads);
+            });
+    }
+
+    //return vector of events
+    vector<Event> event_vector;
+    for (const vector<Node>& node_vector : new_recovered)
+    {
+        for (Node node : node_vector)
+        {
+            event_vector.emplace_back(node,RECOVERY);
+        }
+    }
+    for (const vector<Node>& node_vector : new_onset)
+    {
+        for (Node node : node_vector)
+        {
+            event_vector.emplace_back(node,ONSET);
+        }
+    }
+    for (const vector<Node>& node_vector : new_infected)
+    {
+        for (Node node : node_vector)
+        {
+            event_vector.emplace_back(node,INFECTION);
+        }
+    }
+    return event_vector;
+}
+
+//apply the events of a time step; with multiple threads, only the onsets and
+//recoveries change the infected neighbors, which are updated in parallel
+void DiscreteSEIR::apply_events(const vector<Event>& event_vector)
+{
+    unsigned int number_of_threads = min(number_of_threads_,
+            unsigned(event_vector.size()/MINIMUM_EVENTS_PER_THREAD + 1));
+    if (number_of_threads == 1)
+    {
+        BaseContagion::apply_events(event_vector);
+        return;
+    }
+
+    //change the state of the nodes involved
+    vector<Event> neighbor_event_vector;
+    for (const Event& event : event_vector)
+    {
+        Node node = event.first;
+        if (event.second == INFECTION)
+        {
+            infect(node);
+        }
+        else if (event.second == ONSET)
+        {
+            if (state_vector_[node] != E)
+            {
+                throw runtime_error("Onset attempt: the node is not exposed");
+            }
+            FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+            state_vector_[node] = I;
+            onset_event_set_.erase(node);
+            recovery_event_set_.insert(node, 1.);
+            neighbor_event_vector.emplace_back(node,INFECTION);
+        }
+        else if (event.second == RECOVERY)
+        {
+            if (state_vector_[node] != I)
+            {
+                throw runtime_error("Recovery attempt: the node is not infected");
+            }
+            FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+            state_vector_[node] = R;
+            infected_node_set_.erase(node);
+            recovered_node_set_.insert(node);
+            recovery_event_set_.erase(node);
+            neighbor_event_vector.emplace_back(node,RECOVERY);
+        }
+    }
+    update_neighbors(neighbor_event_vector, number_of_threads);
+}
+
+//clear the state; as if all node became susceptible at this time
+//clear all measures as well
+//overload DiscreteSIR
+void DiscreteSEIR::clear()
+{
+    DiscreteSIR::clear();
+    onset_event_set_.clear();
+}
+
+//write the onset parameter and event set after the SIR state
+void DiscreteSEIR::write_state(ostream& stream) const
+{
+    DiscreteSIR::write_state(stream);
+    sset::write_binary(stream, onset_probability_);
+    onset_event_set_.save(stream);
+}
+
+//read the state written by write_state
+void DiscreteSEIR::read_state(istream& stream)
+{
+    DiscreteSIR::read_state(stream);
+    sset::read_binary(stream, onset_probability_);
+    onset_event_set_.load(stream);
+}
+
+}//end of namespace fastsir
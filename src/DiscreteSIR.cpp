@@ -23,6 +23,8 @@
  */
 
 #include "DiscreteSIR.hpp"
+#include "Parallel.hpp"
+#include <cstdint>
 #include <optional>
 #include <utility>
 #include <iostream>
@@ -37,42 +39,96 @@ namespace fastsir
 
 //constructor of the class
 DiscreteSIR::DiscreteSIR(const EdgeList& edge_list, double recovery_probability,
+        const std::vector<double>& infection_probability, bool directed):
+    DiscreteSIR(make_shared<const Network>(edge_list, directed), recovery_probability,
+            infection_probability)
+{
+}
+
+//constructor of the class provided the network
+DiscreteSIR::DiscreteSIR(shared_ptr<const Network> network, double recovery_probability,
         const std::vector<double>& infection_probability):
-    BaseContagion(edge_list),
+    BaseContagion(move(network)),
     recovery_probability_(recovery_probability),
     infection_probability_(infection_probability),
     infection_propensity_(),
-    infection_event_set_(1.,1.),
-    recovery_event_set_(1.,1.),
-    poisson_dist_(1.),
-    binomial_dist_(1,recovery_probability)
+    infection_event_set_(),
+    recovery_event_set_(),
+    number_of_threads_(1),
+    touched_vector_(network_->size(), 0)
+{
+    set_infection_probability(infection_probability);
+}
+
+//set new infection probabilities; the event set is rebuilt in a single pass
+//over the susceptible nodes with infected neighbors
+void DiscreteSIR::set_infection_probability(const vector<double>& infection_probability)
 {
+    check_infection_rate(infection_probability);
+
     //calculate Poisson rate equivalent for each probability
-    double min = std::numeric_limits<double>::infinity();
-    double max = 0;
-    double propensity = 0;
+    vector<double> infection_propensity;
     for (double prob : infection_probability)
     {
-        if (prob >= 1.)
-        {
-            throw runtime_error("Probability of infection too high (>=1)");
-        }
-        propensity = -log(1.-prob);
-        infection_propensity_.push_back(propensity);
-        if (propensity > max)
+        infection_propensity.push_back(-log(1.-prob));
+    }
+
+    //the probabilities are only replaced once they are known to cover
+    //every infected degree
+    vector<pair<Node,double>> element_weight_vector;
+    for (Node node : get_nodes_at_risk())
+    {
+        double propensity = infection_propensity.at(get_infected_degree(node));
+        if (propensity > 0)
         {
-            max = propensity;
+            element_weight_vector.emplace_back(node, propensity);
         }
-        if (propensity < min and propensity > 0)
+    }
+    infection_probability_ = infection_probability;
+    infection_propensity_ = infection_propensity;
+    infection_event_set_.assign(element_weight_vector);
+}
+
+//set a new recovery probability
+void DiscreteSIR::set_recovery_probability(double recovery_probability)
+{
+    check_recovery_rate(recovery_probability);
+    recovery_probability_ = recovery_probability;
+}
+
+//the rates of a discrete process are its probabilities per time step
+void DiscreteSIR::check_infection_rate(const vector<double>& infection_probability) const
+{
+    check_rate_per_degree(infection_probability);
+    for (double prob : infection_probability)
+    {
+        if (prob >= 1.)
         {
-            min = propensity;
+            throw runtime_error("Probability of infection too high (>=1)");
         }
     }
-    infection_event_set_ = sset::SamplableSet<Node>(min,max); //set true bounds
 }
 
-//update the infection propensity of a neighbor node
-inline void DiscreteSIR::update_infection_propensity(Node node, const Event& event)
+void DiscreteSIR::check_recovery_rate(double recovery_probability) const
+{
+    if (recovery_probability < 0 or recovery_probability > 1)
+    {
+        throw invalid_argument("Recovery probability must be in [0,1]");
+    }
+}
+
+//set the number of threads used to perform a time step
+void DiscreteSIR::set_number_of_threads(unsigned int number_of_threads)
+{
+    if (number_of_threads < 1)
+    {
+        throw invalid_argument("The number of threads must be at least 1");
+    }
+    number_of_threads_ = number_of_threads;
+}
+
+//update the infected neighbors of a susceptible node
+void DiscreteSIR::update_infected_neighbors(Node node, const Event& event)
 {
     Node other_node = event.first;
     Action action = event.second;
@@ -80,7 +136,6 @@ inline void DiscreteSIR::update_infection_propensity(Node node, const Event& eve
     vector<Node>& infected_neighbors = infected_neighbors_vector_[node];
     unordered_map<Node,size_t>& infected_neighbor_position =  infected_neighbor_position_vector_[node];
 
-    size_t size_before = infected_neighbors.size();
     if (action == RECOVERY)
     {
         size_t position = infected_neighbor_position[other_node];
@@ -100,8 +155,11 @@ inline void DiscreteSIR::update_infection_propensity(Node node, const Event& eve
         infected_neighbor_position[other_node] = infected_neighbors.size();
         infected_neighbors.push_back(other_node);
     }
+}
 
-    //update event set with new propensity
+//update the infection propensity of a susceptible node
+void DiscreteSIR::update_infection_propensity(Node node)
+{
     double new_propensity;
      new_propensity = get_infection_propensity(node);
     if (new_propensity > 0)
@@ -115,7 +173,7 @@ inline void DiscreteSIR::update_infection_propensity(Node node, const Event& eve
 }
 
 //infect a node
-inline void DiscreteSIR::infect(Node node)
+void DiscreteSIR::infect(Node node)
 {
     if (state_vector_[node] == S)
     {
@@ -123,11 +181,13 @@ inline void DiscreteSIR::infect(Node node)
         state_vector_[node] = I;
         infected_node_set_.insert(node);
         Event event = make_pair(node,INFECTION);
-        for (Node neighbor : network_.adjacent_nodes(node))
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
         {
             if (state_vector_[neighbor] == S)
             {
-                update_infection_propensity(neighbor, event);
+                update_infected_neighbors(neighbor, event);
+                update_infection_propensity(neighbor);
             }
         }
         //create a recovery event for the node
@@ -143,7 +203,7 @@ inline void DiscreteSIR::infect(Node node)
 }
 
 //recover a node
-inline void DiscreteSIR::recover(Node node)
+void DiscreteSIR::recover(Node node)
 {
     if (state_vector_[node] == I)
     {
@@ -151,11 +211,13 @@ inline void DiscreteSIR::recover(Node node)
         infected_node_set_.erase(node);
         recovered_node_set_.insert(node);
         Event event = make_pair(node,RECOVERY);
-        for (Node neighbor : network_.adjacent_nodes(node))
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
         {
             if (state_vector_[neighbor] == S)
             {
-                update_infection_propensity(neighbor, event);
+                update_infected_neighbors(neighbor, event);
+                update_infection_propensity(neighbor);
             }
         }
         //erase the recovery event for the node
@@ -169,47 +231,173 @@ inline void DiscreteSIR::recover(Node node)
 
 
 //advance the process to the next step by performing infection/recovery
+//each infected node recovers with the recovery probability and each
+//susceptible node is infected with the probability of its infected degree,
+//independently
 inline vector<Event> DiscreteSIR::next_step()
 {
     current_time_ = last_event_time_ + get_lifetime();
     last_event_time_ = current_time_;
 
-    pair<Node,double> node_weight_pair;
-    //get the number of recoveries and assign them
-    binomial_dist_ = binomial_distribution<int>(
-            recovery_event_set_.size(),recovery_probability_);
-    int nb_rec = binomial_dist_(gen_);
-    unordered_set<Node> new_susceptible; //use a set to discard repetition
-    for (int i = 0; i < nb_rec; i++)
+    double recovery_probability = recovery_probability_;
+    auto recovery_func = [recovery_probability](double)
+        {return recovery_probability;};
+    //the propensity is the Poisson rate equivalent
+    auto infection_func = [](double propensity)
+        {return -expm1(-propensity);};
+
+    //decisions only depend on the current state; each thread visits a part of
+    //the event sets with its own RNG stream
+    unsigned int number_of_threads = min(number_of_threads_, unsigned(
+            (recovery_event_set_.size() + infection_event_set_.size())
+            /MINIMUM_EVENTS_PER_THREAD + 1));
+    vector<vector<Node>> new_recovered(number_of_threads);
+    vector<vector<Node>> new_infected(number_of_threads);
+    if (number_of_threads == 1)
     {
-        node_weight_pair = (recovery_event_set_.sample()).value();
-        new_susceptible.insert(node_weight_pair.first);
+        recovery_event_set_.sample_independent_ext_RNG(recovery_func,
+                new_recovered[0], gen_);
+        infection_event_set_.sample_independent_ext_RNG(infection_func,
+                new_infected[0], gen_);
     }
-
-    //get the number of infections and assign them
-    poisson_dist_ = poisson_distribution<int>(
-            infection_event_set_.total_weight());
-    int nb_inf = poisson_dist_(gen_);
-    unordered_set<Node> new_infected;
-    for (int i = 0; i < nb_inf; i++)
+    else
     {
-        node_weight_pair = (infection_event_set_.sample()).value();
-        new_infected.insert(node_weight_pair.first);
+        uint64_t stream_seed = (uint64_t(gen_()) << 32) | gen_();
+        parallel_for(number_of_threads, [&](unsigned int thread_index)
+            {
+                sset::RNGType gen(stream_seed, thread_index);
+                recovery_event_set_.sample_independent_ext_RNG(recovery_func,
+                        new_recovered[thread_index], gen, thread_index,
+                        number_of_threads);
+                infection_event_set_.sample_independent_ext_RNG(infection_func,
+                        new_infected[thread_index], gen, thread_index,
+                        number_of_threads);
+            });
     }
 
     //return vector of events
     vector<Event> event_vector;
-    for (Node node : new_susceptible)
+    for (const vector<Node>& node_vector : new_recovered)
     {
-        event_vector.emplace_back(node,RECOVERY);
+        for (Node node : node_vector)
+        {
+            event_vector.emplace_back(node,RECOVERY);
+        }
     }
-    for (Node node : new_infected)
+    for (const vector<Node>& node_vector : new_infected)
     {
-        event_vector.emplace_back(node,INFECTION);
+        for (Node node : node_vector)
+        {
+            event_vector.emplace_back(node,INFECTION);
+        }
     }
     return event_vector;
 }
 
+//apply the events of a time step; with multiple threads, the infected
+//neighbors of each susceptible node are updated by the thread that owns it
+void DiscreteSIR::apply_events(const vector<Event>& event_vector)
+{
+    unsigned int number_of_threads = min(number_of_threads_,
+            unsigned(event_vector.size()/MINIMUM_EVENTS_PER_THREAD + 1));
+    if (number_of_threads == 1)
+    {
+        BaseContagion::apply_events(event_vector);
+        return;
+    }
+
+    //change the state of the nodes involved
+    for (const Event& event : event_vector)
+    {
+        Node node = event.first;
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        if (event.second == INFECTION)
+        {
+            if (state_vector_[node] != S)
+            {
+                throw runtime_error("Infection attempt: the node is not susceptible");
+            }
+            infection_event_set_.erase(node);
+            state_vector_[node] = I;
+            infected_node_set_.insert(node);
+            recovery_event_set_.insert(node, 1.);
+            infected_neighbors_vector_[node].clear();
+            infected_neighbor_position_vector_[node].clear();
+        }
+        else if (event.second == RECOVERY)
+        {
+            if (state_vector_[node] != I)
+            {
+                throw runtime_error("Recovery attempt: the node is not infected");
+            }
+            state_vector_[node] = R;
+            infected_node_set_.erase(node);
+            recovered_node_set_.insert(node);
+            recovery_event_set_.erase(node);
+        }
+    }
+    update_neighbors(event_vector, number_of_threads);
+}
+
+//update the infected neighbors of the susceptible neighbors of the nodes
+//that became infectious (INFECTION) or stopped being infectious (RECOVERY);
+//the infected neighbors of each node are updated by the thread that owns it
+void DiscreteSIR::update_neighbors(const vector<Event>& event_vector,
+        unsigned int number_of_threads)
+{
+    //each thread distributes the neighbors of a part of the events to the
+    //threads owning them
+    size_t block_size = network_->size()/number_of_threads + 1;
+    vector<vector<vector<pair<Node,size_t>>>> update_matrix(number_of_threads,
+            vector<vector<pair<Node,size_t>>>(number_of_threads));
+    parallel_for(number_of_threads, [&](unsigned int thread_index)
+        {
+            size_t first = (event_vector.size()*thread_index)/number_of_threads;
+            size_t last = (event_vector.size()*(thread_index+1))/number_of_threads;
+            for (size_t i = first; i < last; i++)
+            {
+                for (Node neighbor : network_->adjacent_nodes(event_vector[i].first))
+                {
+                    if (state_vector_[neighbor] == S)
+                    {
+                        update_matrix[thread_index][neighbor/block_size].emplace_back(
+                                neighbor, i);
+                    }
+                }
+            }
+        });
+
+    //owners update the infected neighbors, in a deterministic order
+    vector<vector<Node>> touched_node_vector(number_of_threads);
+    parallel_for(number_of_threads, [&](unsigned int thread_index)
+        {
+            for (unsigned int source = 0; source < number_of_threads; source++)
+            {
+                for (const pair<Node,size_t>& update :
+                        update_matrix[source][thread_index])
+                {
+                    Node node = update.first;
+                    update_infected_neighbors(node, event_vector[update.second]);
+                    if (not touched_vector_[node])
+                    {
+                        touched_vector_[node] = 1;
+                        touched_node_vector[thread_index].push_back(node);
+                    }
+                }
+            }
+        });
+
+    //the event set is updated once per node
+    for (const vector<Node>& node_vector : touched_node_vector)
+    {
+        for (Node node : node_vector)
+        {
+            touched_vector_[node] = 0;
+            update_infection_propensity(node);
+        }
+    }
+}
+
 
 //clear the state; as if all node became susceptible at this time
 //clear all measures as well
@@ -217,8 +405,31 @@ inline vector<Event> DiscreteSIR::next_step()
 void DiscreteSIR::clear()
 {
     BaseContagion::clear();
-    infection_event_set_.clear(); //to avoid numerical error accumulation
-    recovery_event_set_.clear(); //to avoid numerical error accumulation
+    infection_event_set_.clear();
+    recovery_event_set_.clear();
+}
+
+//write the parameters and event sets after the common state
+void DiscreteSIR::write_state(ostream& stream) const
+{
+    BaseContagion::write_state(stream);
+    sset::write_binary(stream, recovery_probability_);
+    sset::write_binary_vector(stream, infection_probability_);
+    sset::write_binary_vector(stream, infection_propensity_);
+    infection_event_set_.save(stream);
+    recovery_event_set_.save(stream);
+}
+
+//read the state written by write_state
+void DiscreteSIR::read_state(istream& stream)
+{
+    BaseContagion::read_state(stream);
+    touched_vector_.assign(network_->size(), 0);
+    sset::read_binary(stream, recovery_probability_);
+    sset::read_binary_vector(stream, infection_probability_);
+    sset::read_binary_vector(stream, infection_propensity_);
+    infection_event_set_.load(stream);
+    recovery_event_set_.load(stream);
 }
 
 
@@ -26,17 +26,21 @@
 #define DISCRETESIR_HPP_
 
 #include "BaseContagion.hpp"
+#include "SamplableSet/UniformSet.hpp"
 
 namespace fastsir
 {//start of namespace fastsir
 
 
-//class to simulate SIS process on networks
+//class to simulate SIR process on networks
 class DiscreteSIR : public BaseContagion
 {
 public:
     //Constructor
     DiscreteSIR(const EdgeList& edge_list, double recovery_probability,
+                const std::vector<double>& infection_probability,
+                bool directed = false);
+    DiscreteSIR(std::shared_ptr<const Network> network, double recovery_probability,
                 const std::vector<double>& infection_probability);
 
     //Accessors
@@ -44,7 +48,18 @@ public:
         {return infected_node_set_.size() == 0 ?
             std::numeric_limits<double>::infinity() : 1.;}
 
+    unsigned int get_number_of_threads() const
+        {return number_of_threads_;}
+
     //Mutators
+    void set_number_of_threads(unsigned int number_of_threads);
+    void set_infection_probability(const std::vector<double>& infection_probability);
+    void set_recovery_probability(double recovery_probability);
+    //the rates of a discrete process are its probabilities per time step
+    void set_infection_rate(const std::vector<double>& infection_probability)
+        {set_infection_probability(infection_probability);}
+    void set_recovery_rate(double recovery_probability)
+        {set_recovery_probability(recovery_probability);}
     void clear();
 
 protected:
@@ -53,19 +68,39 @@ protected:
     std::vector<double> infection_probability_; //per node in group
     std::vector<double> infection_propensity_; //Poisson rate equiv
     sset::SamplableSet<Node> infection_event_set_;
-    sset::SamplableSet<Node> recovery_event_set_;
-    std::poisson_distribution<int> poisson_dist_;
-    std::binomial_distribution<int> binomial_dist_;
+    sset::UniformSet<Node> recovery_event_set_;
+    unsigned int number_of_threads_;
+    std::vector<char> touched_vector_; //nodes with a new infected degree
+
+    //a step is done on multiple threads only if there are enough events
+    static constexpr std::size_t MINIMUM_EVENTS_PER_THREAD = 1000;
 
     //utility functions
     inline double get_infection_propensity(Node node) const
         {return infection_propensity_.at(get_infected_degree(node));}
 
-    inline void update_infection_propensity(Node node, const Event& event);
+    void update_infected_neighbors(Node node, const Event& event);
+    void update_infection_propensity(Node node);
+    void check_infection_rate(const std::vector<double>& infection_probability) const;
+    void check_recovery_rate(double recovery_probability) const;
 
-    inline void infect(Node node);
-    inline void recover(Node node);
+    void infect(Node node);
+    void recover(Node node);
     inline std::vector<Event> next_step();
+    void apply_events(const std::vector<Event>& event_vector);
+    void update_neighbors(const std::vector<Event>& event_vector,
+            unsigned int number_of_threads);
+    bool is_discrete_time() const
+        {return true;}
+
+    std::string get_model_name() const
+        {return "DiscreteSIR";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<DiscreteSIR>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<DiscreteSIR&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
 };
 
 }//end of namespace fastsir
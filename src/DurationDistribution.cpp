@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DurationDistribution.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+DurationDistribution::DurationDistribution(const string& name,
+        const vector<double>& parameters):
+    name_(name),
+    parameters_(parameters),
+    kind_(DurationKind::NONE),
+    exponential_dist_(),
+    gamma_dist_(),
+    lognormal_dist_(),
+    weibull_dist_()
+{
+    if (name == "none")
+    {
+        parameter_checkup(0);
+    }
+    else if (name == "exponential")
+    {
+        parameter_checkup(1);
+        kind_ = DurationKind::EXPONENTIAL;
+        exponential_dist_ = exponential_distribution<double>(parameters[0]);
+    }
+    else if (name == "gamma")
+    {
+        parameter_checkup(2);
+        kind_ = DurationKind::GAMMA;
+        gamma_dist_ = gamma_distribution<double>(parameters[0], parameters[1]);
+    }
+    else if (name == "lognormal")
+    {
+        parameter_checkup(2);
+        kind_ = DurationKind::LOGNORMAL;
+        lognormal_dist_ = lognormal_distribution<double>(parameters[0], parameters[1]);
+    }
+    else if (name == "weibull")
+    {
+        parameter_checkup(2);
+        kind_ = DurationKind::WEIBULL;
+        weibull_dist_ = weibull_distribution<double>(parameters[0], parameters[1]);
+    }
+    else if (name == "fixed")
+    {
+        parameter_checkup(1);
+        kind_ = DurationKind::FIXED;
+    }
+    else
+    {
+        throw invalid_argument("Unknown duration distribution: " + name);
+    }
+}
+
+//throw an invalid_argument error if the parameters are inconsistent
+void DurationDistribution::parameter_checkup(size_t number_of_parameters) const
+{
+    if (parameters_.size() != number_of_parameters)
+    {
+        throw invalid_argument("Wrong number of parameters for the "
+                + name_ + " distribution");
+    }
+    for (size_t i = 0; i < parameters_.size(); i++)
+    {
+        //the location parameter of the lognormal can be negative
+        bool can_be_negative = (name_ == "lognormal" and i == 0);
+        if (not isfinite(parameters_[i]) or
+                (parameters_[i] <= 0 and not can_be_negative))
+        {
+            throw invalid_argument("Invalid parameter for the "
+                    + name_ + " distribution");
+        }
+    }
+}
+
+//mean duration
+double DurationDistribution::mean() const
+{
+    switch (kind_)
+    {
+        case DurationKind::EXPONENTIAL:
+            return 1./parameters_[0];
+        case DurationKind::GAMMA:
+            return parameters_[0]*parameters_[1];
+        case DurationKind::LOGNORMAL:
+            return exp(parameters_[0] + parameters_[1]*parameters_[1]/2);
+        case DurationKind::WEIBULL:
+            return parameters_[1]*tgamma(1. + 1./parameters_[0]);
+        case DurationKind::FIXED:
+            return parameters_[0];
+        default:
+            return 0.;
+    }
+}
+
+//draw a duration
+double DurationDistribution::operator()(sset::RNGType& gen)
+{
+    switch (kind_)
+    {
+        case DurationKind::EXPONENTIAL:
+            return exponential_dist_(gen);
+        case DurationKind::GAMMA:
+            return gamma_dist_(gen);
+        case DurationKind::LOGNORMAL:
+            return lognormal_dist_(gen);
+        case DurationKind::WEIBULL:
+            return weibull_dist_(gen);
+        case DurationKind::FIXED:
+            return parameters_[0];
+        default:
+            return 0.;
+    }
+}
+
+//write the distribution in binary; the random distributions are written in
+//text, since they can hold a cached value
+void DurationDistribution::save(ostream& stream) const
+{
+    sset::write_binary_string(stream, name_);
+    sset::write_binary_vector(stream, parameters_);
+    ostringstream dist_stream;
+    dist_stream << exponential_dist_ << " " << gamma_dist_ << " "
+        << lognormal_dist_ << " " << weibull_dist_;
+    sset::write_binary_string(stream, dist_stream.str());
+}
+
+//read a distribution written with save
+void DurationDistribution::load(istream& stream)
+{
+    string name = sset::read_binary_string(stream);
+    vector<double> parameters;
+    sset::read_binary_vector(stream, parameters);
+    istringstream dist_stream(sset::read_binary_string(stream));
+    try
+    {
+        DurationDistribution distribution(name, parameters);
+        if (not (dist_stream >> distribution.exponential_dist_ >> distribution.gamma_dist_
+                    >> distribution.lognormal_dist_ >> distribution.weibull_dist_))
+        {
+            throw invalid_argument("Invalid random distributions");
+        }
+        *this = distribution;
+    }
+    catch (const invalid_argument&)
+    {
+        throw runtime_error("Invalid duration distribution in state file");
+    }
+}
+
+}//end of namespace fastsir
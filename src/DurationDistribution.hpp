@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DURATIONDISTRIBUTION_HPP_
+#define DURATIONDISTRIBUTION_HPP_
+
+#include "SamplableSet/SamplableSet.hpp"
+#include <string>
+#include <vector>
+#include <random>
+#include <iostream>
+
+namespace fastsir
+{//start of namespace fastsir
+
+enum class DurationKind {NONE, EXPONENTIAL, GAMMA, LOGNORMAL, WEIBULL, FIXED};
+
+
+/*
+ * Distribution of the time spent in a compartment (infectious period,
+ * latency, etc.). Supported names and parameters are
+ *   "none"        : []               (zero duration)
+ *   "exponential" : [rate]
+ *   "gamma"       : [shape, scale]
+ *   "lognormal"   : [mu, sigma]      (of the underlying normal distribution)
+ *   "weibull"     : [shape, scale]
+ *   "fixed"       : [duration]
+ */
+class DurationDistribution
+{
+public:
+    //Constructor
+    DurationDistribution(const std::string& name = "none",
+                         const std::vector<double>& parameters = std::vector<double>());
+
+    //Accessors
+    const std::string& get_name() const
+        {return name_;}
+    const std::vector<double>& get_parameters() const
+        {return parameters_;}
+    bool is_none() const
+        {return kind_ == DurationKind::NONE;}
+    double mean() const;
+    void save(std::ostream& stream) const;
+
+    //Mutators
+    double operator()(sset::RNGType& gen);
+    void load(std::istream& stream);
+
+private:
+    //Members
+    std::string name_;
+    std::vector<double> parameters_;
+    DurationKind kind_;
+    std::exponential_distribution<double> exponential_dist_;
+    std::gamma_distribution<double> gamma_dist_;
+    std::lognormal_distribution<double> lognormal_dist_;
+    std::weibull_distribution<double> weibull_dist_;
+
+    //utility functions
+    void parameter_checkup(std::size_t number_of_parameters) const;
+};
+
+}//end of namespace fastsir
+
+#endif /* DURATIONDISTRIBUTION_HPP_ */
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "IndexedPriorityQueue.hpp"
+#include "SamplableSet/BinaryIO.hpp"
+#include <stdexcept>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+IndexedPriorityQueue::IndexedPriorityQueue(size_t number_of_nodes):
+    heap_(),
+    position_vector_(number_of_nodes, NPOS)
+{
+}
+
+//put an entry at a position in the heap and record it
+inline void IndexedPriorityQueue::place(size_t position, const TimeNodePair& entry)
+{
+    heap_[position] = entry;
+    position_vector_[entry.second] = position;
+}
+
+//move an entry up until its parent has an earlier time
+void IndexedPriorityQueue::sift_up(size_t position)
+{
+    TimeNodePair entry = heap_[position];
+    while (position > 0)
+    {
+        size_t parent = (position-1)/ARITY;
+        if (heap_[parent].first <= entry.first)
+        {
+            break;
+        }
+        place(position, heap_[parent]);
+        position = parent;
+    }
+    place(position, entry);
+}
+
+//move an entry down until all its children have a later time
+void IndexedPriorityQueue::sift_down(size_t position)
+{
+    TimeNodePair entry = heap_[position];
+    size_t size = heap_.size();
+    while (true)
+    {
+        size_t first_child = ARITY*position + 1;
+        if (first_child >= size)
+        {
+            break;
+        }
+        //find the earliest child
+        size_t last_child = min(first_child + ARITY, size);
+        size_t earliest = first_child;
+        for (size_t child = first_child+1; child < last_child; child++)
+        {
+            if (heap_[child].first < heap_[earliest].first)
+            {
+                earliest = child;
+            }
+        }
+        if (entry.first <= heap_[earliest].first)
+        {
+            break;
+        }
+        place(position, heap_[earliest]);
+        position = earliest;
+    }
+    place(position, entry);
+}
+
+//set the time of the event associated to a node
+//if the node is not in the queue, it is inserted
+void IndexedPriorityQueue::set_time(Node node, double time)
+{
+    size_t position = position_vector_[node];
+    if (position == NPOS)
+    {
+        heap_.emplace_back(time, node);
+        sift_up(heap_.size()-1);
+    }
+    else
+    {
+        double old_time = heap_[position].first;
+        heap_[position].first = time;
+        if (time < old_time)
+        {
+            sift_up(position);
+        }
+        else
+        {
+            sift_down(position);
+        }
+    }
+}
+
+//remove the event associated to a node, if present
+void IndexedPriorityQueue::erase(Node node)
+{
+    size_t position = position_vector_[node];
+    if (position != NPOS)
+    {
+        position_vector_[node] = NPOS;
+        TimeNodePair last = heap_.back();
+        heap_.pop_back();
+        if (position < heap_.size())
+        {
+            place(position, last);
+            if (position > 0 and last.first < heap_[(position-1)/ARITY].first)
+            {
+                sift_up(position);
+            }
+            else
+            {
+                sift_down(position);
+            }
+        }
+    }
+}
+
+//remove all events
+void IndexedPriorityQueue::clear()
+{
+    for (const TimeNodePair& entry : heap_)
+    {
+        position_vector_[entry.second] = NPOS;
+    }
+    heap_.clear();
+}
+
+//write the heap, in order, in binary
+void IndexedPriorityQueue::save(ostream& stream) const
+{
+    vector<double> time_vector;
+    vector<Node> node_vector;
+    for (const TimeNodePair& entry : heap_)
+    {
+        time_vector.push_back(entry.first);
+        node_vector.push_back(entry.second);
+    }
+    sset::write_binary_vector(stream, time_vector);
+    sset::write_binary_vector(stream, node_vector);
+}
+
+//replace the content by a heap written with save, for number_of_nodes nodes
+void IndexedPriorityQueue::load(istream& stream, size_t number_of_nodes)
+{
+    vector<double> time_vector;
+    vector<Node> node_vector;
+    sset::read_binary_vector(stream, time_vector);
+    sset::read_binary_vector(stream, node_vector);
+    if (node_vector.size() != time_vector.size())
+    {
+        throw runtime_error("Inconsistent event queue in state file");
+    }
+    vector<TimeNodePair> heap;
+    vector<size_t> position_vector(number_of_nodes, NPOS);
+    for (size_t position = 0; position < node_vector.size(); position++)
+    {
+        Node node = node_vector[position];
+        if (node >= number_of_nodes or position_vector[node] != NPOS
+                or (position > 0 and time_vector[(position-1)/ARITY] > time_vector[position]))
+        {
+            throw runtime_error("Inconsistent event queue in state file");
+        }
+        heap.emplace_back(time_vector[position], node);
+        position_vector[node] = position;
+    }
+    heap_ = move(heap);
+    position_vector_ = move(position_vector);
+}
+
+}//end of namespace fastsir
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INDEXEDPRIORITYQUEUE_HPP_
+#define INDEXEDPRIORITYQUEUE_HPP_
+
+#include "Network.hpp"
+#include <utility>
+#include <vector>
+#include <limits>
+#include <iostream>
+
+namespace fastsir
+{//start of namespace fastsir
+
+typedef std::pair<double,Node> TimeNodePair;
+
+
+/*
+ * Indexed 4-ary min-heap of putative event times, one entry per node at most.
+ * The position of each node in the heap is stored, so that the time of an
+ * event can be changed or the event removed in O(log N).
+ */
+class IndexedPriorityQueue
+{
+public:
+    //Constructor
+    IndexedPriorityQueue(std::size_t number_of_nodes);
+
+    //Accessors
+    std::size_t size() const
+        {return heap_.size();}
+    bool empty() const
+        {return heap_.empty();}
+    bool count(Node node) const
+        {return position_vector_[node] != NPOS;}
+    const TimeNodePair& top() const
+        {return heap_.front();}
+    double get_time(Node node) const
+        {return heap_[position_vector_[node]].first;}
+    void save(std::ostream& stream) const;
+
+    //Mutators
+    void set_time(Node node, double time);
+    void erase(Node node);
+    void clear();
+    void load(std::istream& stream, std::size_t number_of_nodes);
+
+private:
+    //Members
+    static constexpr std::size_t ARITY = 4;
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+    std::vector<TimeNodePair> heap_;
+    std::vector<std::size_t> position_vector_;
+
+    //utility functions
+    inline void place(std::size_t position, const TimeNodePair& entry);
+    void sift_up(std::size_t position);
+    void sift_down(std::size_t position);
+};
+
+}//end of namespace fastsir
+
+#endif /* INDEXEDPRIORITYQUEUE_HPP_ */
@@ -24,16 +24,91 @@
 
 #include "Network.hpp"
 #include <numeric>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
 
 using namespace std;
 
 namespace fastsir
 {//start of namespace fastsir
 
-//Constructor of the class provided an edge list
-Network::Network(const EdgeList& edge_list) :
-	adjacency_list_(), nodes_(),
-    min_degree_(0), max_degree_(0)
+//Constructor of an empty network
+Network::Network() :
+    offset_vector_(1, 0), neighbor_vector_(), weight_vector_(),
+    in_offset_vector_(), in_neighbor_vector_(), in_weight_vector_(),
+    weighted_(false), directed_(false), nodes_(),
+    min_degree_(0), max_degree_(0), max_in_degree_(0)
+{
+}
+
+//Constructor of the class provided an edge list; for a directed network,
+//an edge (i,j) goes from i to j
+Network::Network(const EdgeList& edge_list, bool directed) :
+    offset_vector_(), neighbor_vector_(), weight_vector_(),
+    in_offset_vector_(), in_neighbor_vector_(), in_weight_vector_(),
+    weighted_(false), directed_(directed), nodes_(),
+    min_degree_(0), max_degree_(0), max_in_degree_(0)
+{
+    build(edge_list, nullptr);
+}
+
+//Constructor of the class provided an edge list and the weight of each edge
+Network::Network(const EdgeList& edge_list, const vector<double>& edge_weight,
+        bool directed) :
+    offset_vector_(), neighbor_vector_(), weight_vector_(),
+    in_offset_vector_(), in_neighbor_vector_(), in_weight_vector_(),
+    weighted_(true), directed_(directed), nodes_(),
+    min_degree_(0), max_degree_(0), max_in_degree_(0)
+{
+    if (edge_weight.size() != edge_list.size())
+    {
+        throw invalid_argument("There must be one weight per edge");
+    }
+    for (double weight : edge_weight)
+    {
+        if (not isfinite(weight) or weight < 0)
+        {
+            throw invalid_argument("Edge weights must be finite and positive");
+        }
+    }
+    build(edge_list, &edge_weight);
+}
+
+//Constructor of the class provided the compressed adjacency (the
+//out-neighbors for a directed network)
+Network::Network(vector<size_t> offset_vector, vector<Node> neighbor_vector,
+        vector<double> weight_vector, bool weighted, bool directed) :
+    offset_vector_(move(offset_vector)), neighbor_vector_(move(neighbor_vector)),
+    weight_vector_(move(weight_vector)),
+    in_offset_vector_(), in_neighbor_vector_(), in_weight_vector_(),
+    weighted_(weighted), directed_(directed), nodes_(),
+    min_degree_(0), max_degree_(0), max_in_degree_(0)
+{
+    if (offset_vector_.empty() or offset_vector_.front() != 0
+            or offset_vector_.back() != neighbor_vector_.size()
+            or (weighted_ and weight_vector_.size() != neighbor_vector_.size())
+            or not is_sorted(offset_vector_.begin(), offset_vector_.end()))
+    {
+        throw invalid_argument("Inconsistent compressed adjacency");
+    }
+    nodes_ = vector<Node>(offset_vector_.size() - 1);
+    iota(nodes_.begin(),nodes_.end(),0);
+    for (Node neighbor : neighbor_vector_)
+    {
+        if (neighbor >= nodes_.size())
+        {
+            throw invalid_argument("Inconsistent compressed adjacency");
+        }
+    }
+    build_in_adjacency();
+    set_degree_bounds();
+}
+
+//Fill the compressed adjacency; the neighbors of a node keep the order of the
+//edge list. Each edge is stored in both directions, or only from its first
+//node for a directed network
+void Network::build(const EdgeList& edge_list, const vector<double>* edge_weight)
 {
 	size_t nb_nodes = 0;
 	//Determine the number of nodes
@@ -50,18 +125,89 @@ Network::Network(const EdgeList& edge_list) :
     }
     nb_nodes += 1; //the label starts to 0 by convention
 
-    //Initialize adjacency lists
-    adjacency_list_ = AdjacencyList(nb_nodes, vector<Node>());
     nodes_ = vector<Node>(nb_nodes);
     iota(nodes_.begin(),nodes_.end(),0);
 
+    //offsets from the degrees
+    offset_vector_.assign(nb_nodes + 1, 0);
     for (auto & edge : edge_list)
     {
-        adjacency_list_[edge.first].push_back(edge.second);
-        adjacency_list_[edge.second].push_back(edge.first);
+        offset_vector_[edge.first+1] += 1;
+        if (not directed_)
+        {
+            offset_vector_[edge.second+1] += 1;
+        }
     }
+    partial_sum(offset_vector_.begin(), offset_vector_.end(),
+            offset_vector_.begin());
 
-    //Determine min and max degree
+    neighbor_vector_.resize(offset_vector_.back());
+    if (edge_weight)
+    {
+        weight_vector_.resize(offset_vector_.back());
+    }
+    vector<size_t> position_vector(offset_vector_.begin(), offset_vector_.end() - 1);
+    for (size_t i = 0; i < edge_list.size(); i++)
+    {
+        Node first = edge_list[i].first;
+        Node second = edge_list[i].second;
+        if (edge_weight)
+        {
+            weight_vector_[position_vector[first]] = (*edge_weight)[i];
+        }
+        neighbor_vector_[position_vector[first]++] = second;
+        if (not directed_)
+        {
+            if (edge_weight)
+            {
+                weight_vector_[position_vector[second]] = (*edge_weight)[i];
+            }
+            neighbor_vector_[position_vector[second]++] = first;
+        }
+    }
+    build_in_adjacency();
+    set_degree_bounds();
+}
+
+//Fill the in-neighbors of a directed network from the out-neighbors; they
+//are ordered by label, so a network saved and loaded keeps the same order
+void Network::build_in_adjacency()
+{
+    if (not directed_)
+    {
+        return;
+    }
+    in_offset_vector_.assign(nodes_.size() + 1, 0);
+    for (Node neighbor : neighbor_vector_)
+    {
+        in_offset_vector_[neighbor+1] += 1;
+    }
+    partial_sum(in_offset_vector_.begin(), in_offset_vector_.end(),
+            in_offset_vector_.begin());
+
+    in_neighbor_vector_.resize(neighbor_vector_.size());
+    if (weighted_)
+    {
+        in_weight_vector_.resize(neighbor_vector_.size());
+    }
+    vector<size_t> position_vector(in_offset_vector_.begin(), in_offset_vector_.end() - 1);
+    for (Node node : nodes_)
+    {
+        for (size_t i = offset_vector_[node]; i < offset_vector_[node+1]; i++)
+        {
+            Node neighbor = neighbor_vector_[i];
+            if (weighted_)
+            {
+                in_weight_vector_[position_vector[neighbor]] = weight_vector_[i];
+            }
+            in_neighbor_vector_[position_vector[neighbor]++] = node;
+        }
+    }
+}
+
+//Determine min and max degree, and max in-degree
+void Network::set_degree_bounds()
+{
     for (Node node : nodes_)
     {
         if (node == 0)
@@ -76,6 +222,10 @@ Network::Network(const EdgeList& edge_list) :
         {
             max_degree_ = degree(node);
         }
+        if (in_degree(node) > max_in_degree_)
+        {
+            max_in_degree_ = in_degree(node);
+        }
     }
 }
 
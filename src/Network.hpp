@@ -28,6 +28,7 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <cstddef>
 
 namespace fastsir
 {//start of namespace fastsir
@@ -37,39 +38,130 @@ typedef std::vector<std::pair<Node,Node>> EdgeList;
 typedef std::vector<std::vector<Node> > AdjacencyList;
 
 
-//Structure representing an undirected network
+//View of a contiguous slice of the compressed adjacency
+template <typename T>
+class Range
+{
+public:
+    Range() : begin_(nullptr), end_(nullptr) {}
+    Range(const T* begin, const T* end) : begin_(begin), end_(end) {}
+
+    const T* begin() const
+        {return begin_;}
+    const T* end() const
+        {return end_;}
+    std::size_t size() const
+        {return end_ - begin_;}
+    bool empty() const
+        {return begin_ == end_;}
+    const T& operator[](std::size_t index) const
+        {return begin_[index];}
+
+private:
+    const T* begin_;
+    const T* end_;
+};
+
+
+//Structure representing a network, with optional edge weights.
+//The adjacency is stored in compressed sparse rows: the neighbors of node
+//i are neighbor_vector_[offset_vector_[i]:offset_vector_[i+1]]. An
+//undirected network stores each edge in both rows. A directed network stores
+//the out-neighbors in these rows, and the in-neighbors in separate ones.
 class Network
 {
 public:
     //Constructor
-    Network(const EdgeList& edge_list);
+    Network();
+    Network(const EdgeList& edge_list, bool directed = false);
+    Network(const EdgeList& edge_list, const std::vector<double>& edge_weight,
+            bool directed = false);
+    Network(std::vector<std::size_t> offset_vector,
+            std::vector<Node> neighbor_vector,
+            std::vector<double> weight_vector, bool weighted,
+            bool directed = false);
 
     //Accessors
     std::size_t min_degree() const
         {return min_degree_;}
     std::size_t max_degree() const
         {return max_degree_;}
+    std::size_t max_in_degree() const
+        {return max_in_degree_;}
 
+    //out-degree for a directed network
     std::size_t degree(Node node) const
-    	{return adjacency_list_[node].size();}
+    	{return offset_vector_[node+1] - offset_vector_[node];}
+    std::size_t in_degree(Node node) const
+    	{return get_in_offset_vector()[node+1] - get_in_offset_vector()[node];}
 
     std::size_t size() const
-        {return adjacency_list_.size();}
+        {return nodes_.size();}
     std::size_t number_of_nodes() const
-        {return adjacency_list_.size();}
+        {return nodes_.size();}
+
+    bool is_weighted() const
+        {return weighted_;}
+    bool is_directed() const
+        {return directed_;}
+
+    //out-neighbors for a directed network
+    Range<Node> adjacent_nodes(Node node) const
+    	{return Range<Node>(neighbor_vector_.data() + offset_vector_[node],
+                            neighbor_vector_.data() + offset_vector_[node+1]);}
+    Range<Node> in_adjacent_nodes(Node node) const
+    	{return Range<Node>(get_in_neighbor_vector().data() + get_in_offset_vector()[node],
+                            get_in_neighbor_vector().data() + get_in_offset_vector()[node+1]);}
 
-    const std::vector<Node>& adjacent_nodes(Node node) const
-    	{return adjacency_list_[node];}
+    //weights of the edges to adjacent_nodes(node), in the same order; empty
+    //if the network is unweighted
+    Range<double> edge_weights(Node node) const
+    	{return weighted_ ?
+            Range<double>(weight_vector_.data() + offset_vector_[node],
+                          weight_vector_.data() + offset_vector_[node+1]) :
+            Range<double>();}
+    Range<double> in_edge_weights(Node node) const
+    	{return weighted_ ?
+            Range<double>(get_in_weight_vector().data() + get_in_offset_vector()[node],
+                          get_in_weight_vector().data() + get_in_offset_vector()[node+1]) :
+            Range<double>();}
 
     const std::vector<Node>& nodes() const
         {return nodes_;}
 
+    const std::vector<std::size_t>& get_offset_vector() const
+        {return offset_vector_;}
+    const std::vector<Node>& get_neighbor_vector() const
+        {return neighbor_vector_;}
+    const std::vector<double>& get_weight_vector() const
+        {return weight_vector_;}
+
 private:
     //Members
-    AdjacencyList adjacency_list_;
+    std::vector<std::size_t> offset_vector_;
+    std::vector<Node> neighbor_vector_;
+    std::vector<double> weight_vector_;
+    //in-neighbors, empty for an undirected network
+    std::vector<std::size_t> in_offset_vector_;
+    std::vector<Node> in_neighbor_vector_;
+    std::vector<double> in_weight_vector_;
+    bool weighted_;
+    bool directed_;
     std::vector<Node> nodes_;
     std::size_t min_degree_;
     std::size_t max_degree_;
+    std::size_t max_in_degree_;
+
+    const std::vector<std::size_t>& get_in_offset_vector() const
+        {return directed_ ? in_offset_vector_ : offset_vector_;}
+    const std::vector<Node>& get_in_neighbor_vector() const
+        {return directed_ ? in_neighbor_vector_ : neighbor_vector_;}
+    const std::vector<double>& get_in_weight_vector() const
+        {return directed_ ? in_weight_vector_ : weight_vector_;}
+
+    void build(const EdgeList& edge_list, const std::vector<double>* edge_weight);
+    void build_in_adjacency();
+    void set_degree_bounds();
 
 };
 
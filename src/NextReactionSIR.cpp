@@ -0,0 +1,318 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "NextReactionSIR.hpp"
+#include <optional>
+#include <utility>
+#include <iostream>
+#include <exception>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//value of the residual when no internal time has been drawn for the node
+const double NO_RESIDUAL = -1.;
+
+//constructor of the class
+NextReactionSIR::NextReactionSIR(const EdgeList& edge_list, double recovery_rate,
+        const std::vector<double>& infection_rate, bool directed):
+    NextReactionSIR(make_shared<const Network>(edge_list, directed), recovery_rate,
+            infection_rate)
+{
+}
+
+//constructor of the class with general infectious and latent periods
+NextReactionSIR::NextReactionSIR(const EdgeList& edge_list,
+        const std::vector<double>& infection_rate,
+        const DurationDistribution& infectious_period,
+        const DurationDistribution& latent_period, bool directed):
+    NextReactionSIR(make_shared<const Network>(edge_list, directed), infection_rate,
+            infectious_period, latent_period)
+{
+}
+
+//constructor of the class provided the network
+NextReactionSIR::NextReactionSIR(shared_ptr<const Network> network, double recovery_rate,
+        const std::vector<double>& infection_rate):
+    NextReactionSIR(move(network), infection_rate,
+            DurationDistribution("exponential", {recovery_rate}))
+{
+}
+
+//constructor of the class provided the network, with general infectious and
+//latent periods
+NextReactionSIR::NextReactionSIR(shared_ptr<const Network> network,
+        const std::vector<double>& infection_rate,
+        const DurationDistribution& infectious_period,
+        const DurationDistribution& latent_period):
+    BaseContagion(move(network)),
+    infection_rate_(infection_rate),
+    infectious_period_(infectious_period),
+    latent_period_(latent_period),
+    event_queue_(network_->size()),
+    residual_vector_(network_->size(), NO_RESIDUAL),
+    exponential_dist_(1.)
+{
+}
+
+//set new infection rates; the putative infection times of the susceptible
+//nodes with infected neighbors are rescaled
+void NextReactionSIR::set_infection_rate(const vector<double>& infection_rate)
+{
+    check_infection_rate(infection_rate);
+    vector<double> old_infection_rate = infection_rate_;
+    infection_rate_ = infection_rate;
+    for (Node node : get_nodes_at_risk())
+    {
+        double old_rate = old_infection_rate.at(get_infected_degree(node));
+        double new_rate = get_infection_rate(node);
+        if (new_rate != old_rate)
+        {
+            schedule_infection(node, old_rate, new_rate);
+        }
+    }
+}
+
+//reschedule the infection of a susceptible node after a change of rate;
+//the unused part of the exponential clock is rescaled instead of redrawn
+inline void NextReactionSIR::schedule_infection(Node node, double old_rate,
+        double new_rate)
+{
+    double residual;
+    if (event_queue_.count(node))
+    {
+        residual = old_rate*(event_queue_.get_time(node) - current_time_);
+    }
+    else if (residual_vector_[node] != NO_RESIDUAL)
+    {
+        residual = residual_vector_[node];
+    }
+    else
+    {
+        residual = exponential_dist_(gen_);
+    }
+
+    if (new_rate > 0)
+    {
+        event_queue_.set_time(node, current_time_ + residual/new_rate);
+        residual_vector_[node] = NO_RESIDUAL;
+    }
+    else
+    {
+        //keep the internal time for when the node is exposed again
+        event_queue_.erase(node);
+        residual_vector_[node] = residual;
+    }
+}
+
+//update the infection rate of a neighbor node
+inline void NextReactionSIR::update_infection_rate(Node node, const Event& event)
+{
+    Node other_node = event.first;
+    Action action = event.second;
+
+    vector<Node>& infected_neighbors = infected_neighbors_vector_[node];
+    unordered_map<Node,size_t>& infected_neighbor_position =  infected_neighbor_position_vector_[node];
+
+    double old_rate = get_infection_rate(node);
+    if (action == RECOVERY)
+    {
+        size_t position = infected_neighbor_position[other_node];
+
+        swap(infected_neighbors[position],infected_neighbors.back());
+
+        //also, update the position of the node in the back
+        Node back_node = infected_neighbors[position];
+        infected_neighbor_position[back_node] = position;
+        //pop
+        infected_neighbors.pop_back();
+        infected_neighbor_position.erase(other_node);
+
+    }
+    else if (action == INFECTION)
+    {
+        infected_neighbor_position[other_node] = infected_neighbors.size();
+        infected_neighbors.push_back(other_node);
+    }
+
+    //update the putative infection time with the new rate
+    double new_rate = get_infection_rate(node);
+    if (new_rate != old_rate)
+    {
+        schedule_infection(node, old_rate, new_rate);
+    }
+}
+
+//infect a node; it becomes infectious after the latent period
+inline void NextReactionSIR::infect(Node node)
+{
+    if (state_vector_[node] == S)
+    {
+        event_queue_.erase(node);
+        residual_vector_[node] = NO_RESIDUAL;
+        state_vector_[node] = E;
+        infected_node_set_.insert(node);
+        //clear infected neighbors
+        infected_neighbors_vector_[node].clear();
+        infected_neighbor_position_vector_[node].clear();
+        if (latent_period_.is_none())
+        {
+            onset(node);
+        }
+        else
+        {
+            //schedule the onset of infectiousness for the node
+            event_queue_.set_time(node, current_time_ + latent_period_(gen_));
+        }
+    }
+    else
+    {
+        throw runtime_error("Infection attempt: the node is not susceptible");
+    }
+}
+
+//make a latent node infectious
+inline void NextReactionSIR::onset(Node node)
+{
+    if (state_vector_[node] == E)
+    {
+        state_vector_[node] = I;
+        Event event = make_pair(node,INFECTION);
+        FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+        for (Node neighbor : network_->adjacent_nodes(node))
+        {
+            if (state_vector_[neighbor] == S)
+            {
+                update_infection_rate(neighbor, event);
+            }
+        }
+        //schedule the recovery of the node
+        event_queue_.set_time(node, current_time_ + infectious_period_(gen_));
+    }
+    else
+    {
+        throw runtime_error("Onset attempt: the node is not latent");
+    }
+}
+
+//recover a node; latent nodes can only be recovered when clearing the state
+inline void NextReactionSIR::recover(Node node)
+{
+    if (state_vector_[node] == I or state_vector_[node] == E)
+    {
+        bool infectious = (state_vector_[node] == I);
+        state_vector_[node] = R;
+        infected_node_set_.erase(node);
+        recovered_node_set_.insert(node);
+        //erase the recovery (or onset) event for the node
+        event_queue_.erase(node);
+        if (infectious)
+        {
+            Event event = make_pair(node,RECOVERY);
+            FASTSIR_PROFILE_ADD(neighbor_visits, network_->degree(node));
+            for (Node neighbor : network_->adjacent_nodes(node))
+            {
+                if (state_vector_[neighbor] == S)
+                {
+                    update_infection_rate(neighbor, event);
+                }
+            }
+        }
+    }
+    else
+    {
+        throw runtime_error("Recovery attempt: the node is not infected");
+    }
+}
+
+
+//advance the process to the next step by performing the earliest event
+inline vector<Event> NextReactionSIR::next_step()
+{
+    current_time_ = event_queue_.top().first;
+    last_event_time_ = current_time_;
+    vector<Event> event_vector;
+
+    //the type of the event is determined by the state of the node
+    Node node = event_queue_.top().second;
+    if (state_vector_[node] == S)
+    {
+        event_vector.emplace_back(node,INFECTION);
+    }
+    else if (state_vector_[node] == E)
+    {
+        event_vector.emplace_back(node,ONSET);
+    }
+    else
+    {
+        event_vector.emplace_back(node,RECOVERY);
+    }
+
+    return event_vector;
+}
+
+
+//clear the state; as if all node became susceptible at this time
+//clear all measures as well
+//overload BaseContagion
+void NextReactionSIR::clear()
+{
+    BaseContagion::clear();
+    event_queue_.clear();
+    fill(residual_vector_.begin(), residual_vector_.end(), NO_RESIDUAL);
+}
+
+//write the parameters and the putative event times after the common state
+void NextReactionSIR::write_state(ostream& stream) const
+{
+    BaseContagion::write_state(stream);
+    sset::write_binary_vector(stream, infection_rate_);
+    infectious_period_.save(stream);
+    latent_period_.save(stream);
+    event_queue_.save(stream);
+    sset::write_binary_vector(stream, residual_vector_);
+}
+
+//read the state written by write_state
+void NextReactionSIR::read_state(istream& stream)
+{
+    BaseContagion::read_state(stream);
+    sset::read_binary_vector(stream, infection_rate_);
+    infectious_period_.load(stream);
+    latent_period_.load(stream);
+    event_queue_.load(stream, network_->size());
+    sset::read_binary_vector(stream, residual_vector_);
+    if (residual_vector_.size() != network_->size())
+    {
+        throw runtime_error("Inconsistent residuals in state file");
+    }
+}
+
+
+
+}//end of namespace fastsir
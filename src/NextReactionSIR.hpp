@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NEXTREACTIONSIR_HPP_
+#define NEXTREACTIONSIR_HPP_
+
+#include "BaseContagion.hpp"
+#include "IndexedPriorityQueue.hpp"
+#include "DurationDistribution.hpp"
+
+namespace fastsir
+{//start of namespace fastsir
+
+
+//class to simulate SIR process on networks with the next reaction method
+//(Gibson & Bruck); each node holds at most one putative event time, which
+//allows arbitrary distributions for the infectious period and the latency
+class NextReactionSIR : public BaseContagion
+{
+public:
+    //Constructor
+    NextReactionSIR(const EdgeList& edge_list, double recovery_rate,
+                    const std::vector<double>& infection_rate,
+                    bool directed = false);
+    NextReactionSIR(const EdgeList& edge_list,
+                    const std::vector<double>& infection_rate,
+                    const DurationDistribution& infectious_period,
+                    const DurationDistribution& latent_period = DurationDistribution(),
+                    bool directed = false);
+    NextReactionSIR(std::shared_ptr<const Network> network, double recovery_rate,
+                    const std::vector<double>& infection_rate);
+    NextReactionSIR(std::shared_ptr<const Network> network,
+                    const std::vector<double>& infection_rate,
+                    const DurationDistribution& infectious_period,
+                    const DurationDistribution& latent_period = DurationDistribution());
+
+    //Accessors
+    double get_lifetime() const
+        {return event_queue_.empty() ?
+            std::numeric_limits<double>::infinity() :
+            event_queue_.top().first - last_event_time_;}
+
+    //Mutators
+    void clear();
+    void set_infection_rate(const std::vector<double>& infection_rate);
+
+protected:
+    //Members
+    std::vector<double> infection_rate_;
+    DurationDistribution infectious_period_;
+    DurationDistribution latent_period_;
+    IndexedPriorityQueue event_queue_;
+    std::vector<double> residual_vector_; //unused internal time of infection
+    std::exponential_distribution<double> exponential_dist_;
+
+    //utility functions
+    inline double get_infection_rate(Node node) const
+        {return infection_rate_.at(get_infected_degree(node));}
+
+    inline void schedule_infection(Node node, double old_rate, double new_rate);
+    //the infection rates can change, the infectious period cannot
+    void check_infection_rate(const std::vector<double>& infection_rate) const
+        {check_rate_per_degree(infection_rate);}
+    inline void update_infection_rate(Node node, const Event& event);
+    std::string get_model_name() const
+        {return "NextReactionSIR";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<NextReactionSIR>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<NextReactionSIR&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
+
+    inline void infect(Node node);
+    inline void recover(Node node);
+    inline void onset(Node node);
+    inline std::vector<Event> next_step();
+};
+
+}//end of namespace fastsir
+
+#endif /* NEXTREACTIONSIR_HPP_ */
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <thread>
+#include <vector>
+#include <exception>
+
+namespace fastsir
+{//start of namespace fastsir
+
+//call func(thread_index) on number_of_threads threads and wait for all of
+//them; the first exception thrown by a thread is rethrown in the caller
+template <typename Func>
+void parallel_for(unsigned int number_of_threads, Func func)
+{
+    if (number_of_threads <= 1)
+    {
+        func(0u);
+        return;
+    }
+    std::vector<std::thread> thread_vector;
+    std::vector<std::exception_ptr> exception_vector(number_of_threads);
+    for (unsigned int thread_index = 0; thread_index < number_of_threads;
+            thread_index++)
+    {
+        thread_vector.emplace_back([&func, &exception_vector, thread_index]()
+            {
+                try
+                {
+                    func(thread_index);
+                }
+                catch (...)
+                {
+                    exception_vector[thread_index] = std::current_exception();
+                }
+            });
+    }
+    for (std::thread& thread : thread_vector)
+    {
+        thread.join();
+    }
+    for (std::exception_ptr& exception : exception_vector)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+}//end of namespace fastsir
+
+#endif /* PARALLEL_HPP_ */
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PERFORMANCECOUNTERS_HPP_
+#define PERFORMANCECOUNTERS_HPP_
+
+#include <chrono>
+
+namespace fastsir
+{//start of namespace fastsir
+
+//counters of the work done by a process and time spent in each phase of
+//evolve; only updated when compiled with FASTSIR_PROFILE
+struct PerformanceCounters
+{
+    unsigned long long infection_events = 0;
+    unsigned long long recovery_events = 0;
+    unsigned long long onset_events = 0;
+    unsigned long long waning_events = 0;
+    unsigned long long neighbor_visits = 0;
+    unsigned long long sample_calls = 0;
+    unsigned long long rejection_trials = 0;
+    unsigned long long set_weight_calls = 0;
+    double next_step_seconds = 0.;
+    double transmission_tree_seconds = 0.;
+    double apply_events_seconds = 0.;
+    double macro_state_seconds = 0.;
+};
+
+#ifdef FASTSIR_PROFILE
+//add the time spent in a scope to an accumulator
+class PhaseTimer
+{
+public:
+    PhaseTimer(double& seconds) :
+        seconds_(seconds), start_(std::chrono::steady_clock::now()) {}
+    ~PhaseTimer()
+        {seconds_ += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start_).count();}
+
+private:
+    double& seconds_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define FASTSIR_PROFILE_ADD(counter, value) (performance_counters_.counter += (value))
+#define FASTSIR_PROFILE_PHASE(phase) PhaseTimer phase##_timer(performance_counters_.phase)
+#else
+#define FASTSIR_PROFILE_ADD(counter, value) ((void)0)
+#define FASTSIR_PROFILE_PHASE(phase) ((void)0)
+#endif
+
+}//end of namespace fastsir
+
+#endif /* PERFORMANCECOUNTERS_HPP_ */
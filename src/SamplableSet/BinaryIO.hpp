@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef BINARYIO_HPP_
+#define BINARYIO_HPP_
+
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sset
+{//start of namespace sset
+
+//Raw binary input/output of trivially copyable values and vectors, used to
+//save the state of the sets and processes. The values are stored in the
+//byte order of the machine.
+
+template <typename T>
+void write_binary(std::ostream& stream, const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void read_binary(std::istream& stream, T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+    if (not stream.read(reinterpret_cast<char*>(&value), sizeof(T)))
+    {
+        throw std::runtime_error("Unexpected end of binary stream");
+    }
+}
+
+template <typename T>
+T read_binary(std::istream& stream)
+{
+    T value;
+    read_binary(stream, value);
+    return value;
+}
+
+template <typename T>
+void write_binary_vector(std::ostream& stream, const std::vector<T>& vector)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+    write_binary(stream, std::uint64_t(vector.size()));
+    stream.write(reinterpret_cast<const char*>(vector.data()), vector.size()*sizeof(T));
+}
+
+template <typename T>
+void read_binary_vector(std::istream& stream, std::vector<T>& vector)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Value must be trivially copyable");
+    vector.resize(read_binary<std::uint64_t>(stream));
+    if (not stream.read(reinterpret_cast<char*>(vector.data()), vector.size()*sizeof(T)))
+    {
+        throw std::runtime_error("Unexpected end of binary stream");
+    }
+}
+
+inline void write_binary_string(std::ostream& stream, const std::string& string)
+{
+    write_binary_vector(stream, std::vector<char>(string.begin(), string.end()));
+}
+
+inline std::string read_binary_string(std::istream& stream)
+{
+    std::vector<char> characters;
+    read_binary_vector(stream, characters);
+    return std::string(characters.begin(), characters.end());
+}
+
+}//end of namespace sset
+
+#endif /* BINARYIO_HPP_ */
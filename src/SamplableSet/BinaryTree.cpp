@@ -24,7 +24,7 @@
 
 #include "BinaryTree.hpp"
 #include <iostream>
-#include <set>
+#include <algorithm>
 
 using namespace std;
 
@@ -34,19 +34,17 @@ namespace sset
 
 //Default constructor of the class BinaryTree
 BinaryTree::BinaryTree() :
-    root_(nullptr),
-    current_node_(nullptr),
-    leaves_vector_(),
-    leaves_index_map_()
+    value_vector_(),
+    number_of_leaves_(0),
+    current_node_(0)
 {
 }
 
 //Constructor of the class BinaryTree with specified leaves number
 BinaryTree::BinaryTree(unsigned int n_leaves) :
-    root_(nullptr),
-    current_node_(nullptr),
-    leaves_vector_(),
-    leaves_index_map_()
+    value_vector_(),
+    number_of_leaves_(0),
+    current_node_(0)
 {
     if (n_leaves < 1)
     {
@@ -54,79 +52,12 @@ BinaryTree::BinaryTree(unsigned int n_leaves) :
     }
     else
     {
-        BinaryTreeNode* root = new BinaryTreeNode;
-        root_ = root;
-        current_node_ = root; //assign current node to the root
-        unsigned int n_nodes = 2*n_leaves - 1; //number of nodes for
-                                               //a full binary tree
-        root->child_left = branch(root, 1, n_nodes);
-        root->child_right = branch(root, 2, n_nodes);
+        number_of_leaves_ = n_leaves;
+        value_vector_.assign(2*n_leaves - 1, 0.); //number of nodes for
+                                                  //a full binary tree
     }
 }
 
-//Copy constructor of the class BinaryTree
-BinaryTree::BinaryTree(const BinaryTree& tree) :
-    root_(nullptr),
-    current_node_(nullptr),
-    leaves_vector_(),
-    leaves_index_map_()
-{
-    //Construct a new tree with n_leaves
-    unsigned int n_leaves = tree.leaves_vector_.size();
-    BinaryTreeNode* root = new BinaryTreeNode;
-    root_ = root;
-    current_node_ = root; //assign current node to the root
-    unsigned int n_nodes = 2*n_leaves - 1; //number of nodes for
-                                           //a full binary tree
-    root->child_left = branch(root, 1, n_nodes);
-    root->child_right = branch(root, 2, n_nodes);
-
-    //Give the same values to the leaves
-    LeafIndex leaf_index = 0;
-    for (auto iter = tree.leaves_vector_.begin();
-        iter != tree.leaves_vector_.end(); ++iter)
-    {
-        update_value(leaf_index, (*iter)->value);
-        leaf_index += 1;
-    }
-}
-
-//Overload the assignement operator
-BinaryTree& BinaryTree::operator=(const BinaryTree& tree)
-{
-    //destroy the current tree
-    this->destroy_tree(root_);
-    this->leaves_vector_.clear();
-    this->leaves_index_map_.clear();
-
-    //Construct a new tree with n_leaves
-    unsigned int n_leaves = tree.leaves_vector_.size();
-    BinaryTreeNode* root = new BinaryTreeNode;
-    root_ = root;
-    current_node_ = root; //assign current node to the root
-    unsigned int n_nodes = 2*n_leaves - 1; //number of nodes for
-                                           //a full binary tree
-    root->child_left = branch(root, 1, n_nodes);
-    root->child_right = branch(root, 2, n_nodes);
-
-    //Give the same values to the leaves
-    LeafIndex leaf_index = 0;
-    for (auto iter = tree.leaves_vector_.begin();
-        iter != tree.leaves_vector_.end(); ++iter)
-    {
-        update_value(leaf_index, (*iter)->value);
-        leaf_index += 1;
-    }
-
-    return *this;
-}
-
-//Destructor of the class
-BinaryTree::~BinaryTree()
-{
-    destroy_tree(root_);
-}
-
 //Get the leaf index associated to the cumulative fraction r
 LeafIndex BinaryTree::get_leaf_index(double r)
 {
@@ -149,55 +80,19 @@ LeafIndex BinaryTree::get_leaf_index(double r)
     return chosen_leaf;
 }
 
-//Recursive method to construct a full binary tree
-BinaryTreeNode* BinaryTree::branch(BinaryTreeNode* parent, int node_index,
-    int n_nodes)
-{
-
-    BinaryTreeNode* node;
-    if(node_index < n_nodes)
-    {
-        //Branch and create childs if possible
-        node = new BinaryTreeNode;
-        node->parent = parent;
-        node->child_left = branch(node, 2*node_index+1, n_nodes);
-        node->child_right = branch(node, 2*node_index+2, n_nodes);
-    }
-    else
-    {
-        node = nullptr;
-        if (leaves_index_map_.find(parent) == leaves_index_map_.end())
-        {
-            //the parent node is identified as a leaf
-            leaves_index_map_[parent] = leaves_vector_.size();
-            leaves_vector_.push_back(parent);
-        }
-    }
-
-    return node;
-}
-
-//Recursively destroy the subtree associated to the node
-void BinaryTree::destroy_tree(BinaryTreeNode* node)
+//update value for the leaf and parents
+void BinaryTree::update_value(LeafIndex leaf_index, double variation)
 {
-  if(node != nullptr)
-  {
-    destroy_tree(node->child_left);
-    destroy_tree(node->child_right);
-    delete node;
-  }
+    current_node_ = leaf_index + number_of_leaves_ - 1;
+    update_value(variation);
 }
 
-//update value for the leaf and parents
-void BinaryTree::update_value(LeafIndex leaf_index, double variation)
+//set value for the leaf and update the parents
+void BinaryTree::set_value(LeafIndex leaf_index, double value)
 {
-    current_node_ = leaves_vector_[leaf_index];
-    (current_node_->value) += variation;
-    while(not is_root())
-    {
-        move_up();
-        (current_node_->value) += variation;
-    }
+    current_node_ = leaf_index + number_of_leaves_ - 1;
+    value_vector_[current_node_] = value;
+    update_parents();
 }
 
 //update value for current leaf
@@ -205,12 +100,8 @@ void BinaryTree::update_value(double variation)
 {
     if (is_leaf())
     {
-        (current_node_->value) += variation;
-        while(not is_root())
-        {
-            move_up();
-            (current_node_->value) += variation;
-        }
+        value_vector_[current_node_] += variation;
+        update_parents();
     }
     else
     {
@@ -222,12 +113,8 @@ void BinaryTree::update_zero()
 {
     if (is_leaf())
     {
-        (current_node_->value) = 0;
-        while(not is_root())
-        {
-            move_up();
-            (current_node_->value) = 0;
-        }
+        value_vector_[current_node_] = 0;
+        update_parents();
     }
     else
     {
@@ -235,14 +122,22 @@ void BinaryTree::update_zero()
     }
 }
 
-//remove value for all nodes
-void BinaryTree::clear()
+//recompute the parents of the current node as the sum of their children;
+//a node is then always the sum of its leaves, without accumulated variations
+void BinaryTree::update_parents()
 {
-    for (auto& leaf : leaves_vector_)
+    while(not is_root())
     {
-        move_at(leaf);
-        update_zero();
+        move_up();
+        value_vector_[current_node_] = get_value_left() + get_value_right();
     }
 }
 
+//remove value for all nodes
+void BinaryTree::clear()
+{
+    fill(value_vector_.begin(), value_vector_.end(), 0.);
+    reset_current_node();
+}
+
 }//end of namespace sset
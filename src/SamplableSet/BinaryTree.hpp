@@ -26,7 +26,6 @@
 #define BINARYTREE_HPP
 
 #include <vector>
-#include <unordered_map>
 #include <cmath>
 
 namespace sset
@@ -34,79 +33,63 @@ namespace sset
 
 //Define new types
 typedef unsigned int LeafIndex;
-
-//Define a structure for the nodes of a binary tree
-struct BinaryTreeNode
-{
-    BinaryTreeNode() : value(0.), parent(nullptr), child_left(nullptr),
-    child_right(nullptr) {}
-    double value;
-    BinaryTreeNode* parent;
-    BinaryTreeNode* child_left;
-    BinaryTreeNode* child_right;
-};
+typedef unsigned int NodeIndex;
 
 //Binary tree to udpate dynamically a cumulative distribution
+//The nodes are stored in a flat array: the children of node i are 2i+1 and
+//2i+2, and the n leaves are the last n nodes. The tree is thus copied and
+//moved as a single vector.
 class BinaryTree
 {
 public:
     //Constructor
     BinaryTree();
     BinaryTree(unsigned int n_leaves);
-    BinaryTree(const BinaryTree& tree);
-
-    //Assignement operator
-    BinaryTree& operator=(const BinaryTree& tree);
-
-    //Destructor
-    ~BinaryTree();
 
     //Accessors
-    bool is_root()
-        {return current_node_->parent == nullptr;}
-    bool is_leaf()
-        {return current_node_->child_left == nullptr and
-            current_node_->child_right == nullptr ;}
+    bool is_root() const
+        {return current_node_ == 0;}
+    bool is_leaf() const
+        {return current_node_ + 1 >= number_of_leaves_;}
     double get_value() const
-        {return current_node_->value;}
+        {return value_vector_[current_node_];}
     double get_value_left() const
-        {return (current_node_->child_left)->value;}
+        {return value_vector_[2*current_node_+1];}
     double get_value_right() const
-        {return (current_node_->child_right)->value;}
+        {return value_vector_[2*current_node_+2];}
+    double get_leaf_value(LeafIndex leaf_index) const
+        {return value_vector_[leaf_index + number_of_leaves_ - 1];}
     LeafIndex get_leaf_index() const
-        {return leaves_index_map_.at(current_node_);}
+        {return current_node_ + 1 - number_of_leaves_;}
     LeafIndex get_leaf_index(double r);
+    unsigned int get_number_of_leaves() const
+        {return number_of_leaves_;}
 
     //Mutators
     void reset_current_node()
-        {current_node_ = root_;}
+        {current_node_ = 0;}
     void move_down_left()
-        {current_node_ = current_node_->child_left;}
+        {current_node_ = 2*current_node_+1;}
     void move_down_right()
-        {current_node_ = current_node_->child_right;}
+        {current_node_ = 2*current_node_+2;}
     void move_up()
-        {current_node_ = current_node_->parent;}
-    void move_at(BinaryTreeNode* node)
+        {current_node_ = (current_node_-1)/2;}
+    void move_at(NodeIndex node)
         {current_node_ = node;}
     void update_value(LeafIndex leaf_index, double variation);
     void update_value(double variation);
+    void set_value(LeafIndex leaf_index, double value);
     void update_zero();
     void clear();
 
 
 private:
     //Members
-    BinaryTreeNode* root_;
-    BinaryTreeNode* current_node_;
-    std::vector<BinaryTreeNode*> leaves_vector_;
-    std::unordered_map<BinaryTreeNode*,LeafIndex> leaves_index_map_;
-
-    //To be called by constructors and assignement operator
-    BinaryTreeNode* branch(BinaryTreeNode* parent, int node_index,
-    int n_nodes);
+    std::vector<double> value_vector_;
+    unsigned int number_of_leaves_;
+    NodeIndex current_node_;
 
-    //to be called by destructor
-    void destroy_tree(BinaryTreeNode* node);
+    void update_parents();
 
 };
 
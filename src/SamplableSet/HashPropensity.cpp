@@ -24,6 +24,7 @@
 
 #include "HashPropensity.hpp"
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 
 using namespace std;
@@ -35,15 +36,23 @@ namespace sset
 //Default constructor
 HashPropensity::HashPropensity(double propensity_min, double propensity_max) :
     propensity_min_(propensity_min), propensity_max_(propensity_max),
-    power_of_two_(false)
+    power_of_two_(false), exponent_min_(0), mantissa_min_(0)
 {
-    if (propensity_min == 0. or isinf(propensity_max))
+    if (propensity_min <= 0. or isinf(propensity_max) or isnan(propensity_max))
     {
         throw invalid_argument("Invalid minimal or maximal weight");
     }
-    if (floor(log2(propensity_max/propensity_min)) ==
-        ceil(log2(propensity_max/propensity_min)) and
-        propensity_max != propensity_min)
+    uint64_t bits;
+    memcpy(&bits, &propensity_min, sizeof(double));
+    exponent_min_ = bits >> 52;
+    mantissa_min_ = bits & MANTISSA_MASK;
+
+    //the maximal weight is the upper bound of the last group instead of
+    //the lower bound of a new group
+    int exponent_min, exponent_max;
+    double fraction_min = frexp(propensity_min, &exponent_min);
+    double fraction_max = frexp(propensity_max, &exponent_max);
+    if (fraction_min == fraction_max and propensity_max > propensity_min)
     {
         power_of_two_ = true;
     }
@@ -53,17 +62,23 @@ HashPropensity::HashPropensity(double propensity_min, double propensity_max) :
 HashPropensity::HashPropensity(const HashPropensity& hash_object) :
     propensity_min_(hash_object.propensity_min_),
     propensity_max_(hash_object.propensity_max_),
-    power_of_two_(hash_object.power_of_two_)
+    power_of_two_(hash_object.power_of_two_),
+    exponent_min_(hash_object.exponent_min_),
+    mantissa_min_(hash_object.mantissa_min_)
 {
 }
 
-//Call operator
-size_t HashPropensity::operator()(double propensity) const
+//Group when the propensity or the minimal propensity is subnormal; frexp
+//normalizes the fraction in [0.5,1)
+int64_t HashPropensity::subnormal_group(double propensity) const
 {
-    size_t index = floor(log2(propensity/propensity_min_));
+    int exponent, exponent_min;
+    double fraction = frexp(propensity, &exponent);
+    double fraction_min = frexp(propensity_min_, &exponent_min);
+    int64_t index = exponent - exponent_min - (fraction < fraction_min);
     if (power_of_two_ and propensity == propensity_max_)
     {
-        index -=1 ;
+        index -= 1;
     }
     return index;
 }
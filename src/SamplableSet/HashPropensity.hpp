@@ -26,10 +26,13 @@
 #define HASHPROPENSITY_HPP_
 
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
 
 namespace sset
 {//start of namespace sset
 
+const std::uint64_t MANTISSA_MASK = (std::uint64_t(1) << 52) - 1;
 
 // Unary function object to hash the propensity of events to groups
 class HashPropensity
@@ -38,17 +41,50 @@ public:
     //Constructor
     HashPropensity(double propensity_min, double propensity_max);
     HashPropensity(const HashPropensity& hash_object);
+    HashPropensity& operator=(const HashPropensity& hash_object) = default;
+
+    //Accessors
+    double get_propensity_min() const {return propensity_min_;}
+    double get_propensity_max() const {return propensity_max_;}
 
     //Call operator definition
-    std::size_t operator()(double propensity) const;
+    inline std::size_t operator()(double propensity) const
+        {return group(propensity);}
+    inline std::int64_t group(double propensity) const;
 
 private:
     //Members
     double propensity_min_;
     double propensity_max_;
     bool power_of_two_;
+    std::int64_t exponent_min_; //biased binary exponent of propensity_min_
+    std::uint64_t mantissa_min_; //fraction bits of propensity_min_
+
+    //utility functions
+    std::int64_t subnormal_group(double propensity) const;
 };
 
+//Group of a propensity: floor(log2(propensity/propensity_min_)), computed
+//exactly from the binary exponents and the fraction bits; it is negative
+//below the minimal propensity
+inline std::int64_t HashPropensity::group(double propensity) const
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &propensity, sizeof(double));
+    std::int64_t exponent = bits >> 52;
+    std::uint64_t mantissa = bits & MANTISSA_MASK;
+    if (exponent == 0 or exponent_min_ == 0)
+    {
+        return subnormal_group(propensity);
+    }
+    std::int64_t index = exponent - exponent_min_ - (mantissa < mantissa_min_);
+    if (power_of_two_ and propensity == propensity_max_)
+    {
+        index -= 1;
+    }
+    return index;
+}
+
 }//end of namespace sset
 
 #endif /* HASHPROPENSITY_HPP_ */
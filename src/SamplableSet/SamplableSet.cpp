@@ -2,6 +2,7 @@
 
 
 sset::RNGType sset::BaseSamplableSet::gen_ = RNGType(time(NULL));
+thread_local sset::SamplingCounters sset::BaseSamplableSet::counters_;
 
 
 //seed the RNG
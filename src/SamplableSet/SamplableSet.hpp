@@ -27,6 +27,7 @@
 
 #include "HashPropensity.hpp"
 #include "BinaryTree.hpp"
+#include "BinaryIO.hpp"
 #include "pcg-cpp/include/pcg_random.hpp"
 #include <utility>
 #include <random>
@@ -35,6 +36,12 @@
 #include <stdio.h>
 #include <time.h>
 #include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace sset
 {//start of namespace sset
@@ -44,18 +51,38 @@ typedef unsigned int InGroupIndex;
 typedef std::pair<GroupIndex, InGroupIndex> SSetPosition; //Set element Id
 typedef pcg32 RNGType;
 
+//Counters of the sampling work, one per thread so that sets used on
+//different threads do not race; only updated when compiled with
+//FASTSIR_PROFILE
+struct SamplingCounters
+{
+    unsigned long long sample_calls = 0;
+    unsigned long long rejection_trials = 0;
+    unsigned long long set_weight_calls = 0;
+};
+
+#ifdef FASTSIR_PROFILE
+#define SSET_PROFILE_ADD(counter, value) (BaseSamplableSet::counters_.counter += (value))
+#else
+#define SSET_PROFILE_ADD(counter, value) ((void)0)
+#endif
+
 //Base class to contain the shared RNG for derived template classes
 class BaseSamplableSet
 {
     public:
         static void seed(unsigned int seed_value);
         static RNGType gen_;
+        static thread_local SamplingCounters counters_;
 };
 
 
 /*
  * Set of elements, samplable efficiently using composition and rejection
- * sampling.
+ * sampling. Elements are grouped by weight in [w0 2^g, w0 2^(g+1)), where w0
+ * is the minimal weight given at construction (1 by default); groups are
+ * added or removed as weights appear or disappear, so any positive weight
+ * is accepted.
  */
 template <class T>
 class SamplableSet : public BaseSamplableSet
@@ -65,9 +92,15 @@ public:
     typedef std::vector<std::pair<T,double> > PropensityGroup;
 
     //Default constructor
+    SamplableSet();
     SamplableSet(double min_weight, double max_weight);
-    //Copy constructor
+    //Copy and move constructors
     SamplableSet(const SamplableSet<T>& s);
+    SamplableSet(SamplableSet<T>&& s);
+
+    //Assignment operators
+    SamplableSet<T>& operator=(const SamplableSet<T>& s);
+    SamplableSet<T>& operator=(SamplableSet<T>&& s);
 
     //Accessors
     std::size_t size() const {return position_map_.size();}
@@ -78,8 +111,22 @@ public:
     template <typename ExtRNG>
     std::optional<std::pair<T,double> > sample_ext_RNG(ExtRNG& gen) const;
     double total_weight() const {return sampling_tree_.get_value();}
+    void sample_n(std::size_t n, std::vector<T>& sample) const;
+    template <typename ExtRNG>
+    void sample_n_ext_RNG(std::size_t n, std::vector<T>& sample, ExtRNG& gen) const;
+    void sample_n_without_replacement(std::size_t n, std::vector<T>& sample) const;
+    template <typename ExtRNG>
+    void sample_n_without_replacement_ext_RNG(std::size_t n, std::vector<T>& sample,
+            ExtRNG& gen) const;
+    template <typename Func>
+    void sample_independent(Func probability, std::vector<T>& sample) const;
+    template <typename Func, typename ExtRNG>
+    void sample_independent_ext_RNG(Func probability, std::vector<T>& sample,
+            ExtRNG& gen, unsigned int part = 0,
+            unsigned int number_of_parts = 1) const;
     std::optional<double> get_weight(const T& element) const;
     std::optional<std::pair<T,double> > get_at_iterator() const;
+    void save(std::ostream& stream) const;
 
     //Mutators
     void insert(const T& element, double weight = 0);
@@ -88,6 +135,8 @@ public:
     void next();
     void init_iterator();
     void clear();
+    void assign(const std::vector<std::pair<T,double> >& element_weight_vector);
+    void load(std::istream& stream);
 
 
 private:
@@ -100,14 +149,43 @@ private:
     std::unordered_map<T,SSetPosition> position_map_;
     mutable BinaryTree sampling_tree_;
     std::vector<PropensityGroup> propensity_group_vector_;
+    std::vector<std::size_t> update_count_vector_; //updates since exact sum
     mutable typename PropensityGroup::iterator iterator_;
     mutable GroupIndex iterator_group_index_;
+    std::int64_t first_group_; //group of propensity_group_vector_[0]
+    //positions store the group offset by GROUP_BIAS, which stays valid
+    //when groups are added in front
+    static constexpr std::int64_t GROUP_BIAS = 1 << 12;
+    //minimal number of updates of a group before its exact sum
+    static constexpr std::size_t MIN_UPDATE_COUNT = 32;
+
     //private method
     void weight_checkup(double weight) const;
+    inline GroupIndex get_group_index(const SSetPosition& position) const
+        {return position.first - GROUP_BIAS - first_group_;}
+    inline double get_group_bound(std::int64_t group) const
+        {return std::min(std::ldexp(hash_.get_propensity_min(), group + 1),
+                std::numeric_limits<double>::max());}
+    void cover_group(std::int64_t group, double weight);
+    void shrink_groups();
+    void rebuild_groups(std::int64_t first_group, std::int64_t last_group);
+    void update_group_weight(GroupIndex group_index, double variation);
+    double exact_group_weight(GroupIndex group_index) const;
+    template <typename ExtRNG>
+    void multinomial_split(std::size_t n, std::vector<std::size_t>& group_count,
+            ExtRNG& gen) const;
 };
 
 
-//Default constructor for the class SamplableSet
+//Default constructor for the class SamplableSet; the groups are anchored
+//at weight 1
+template <typename T>
+SamplableSet<T>::SamplableSet() :
+    SamplableSet(1., 1.)
+{
+}
+
+//Constructor for the class SamplableSet with the expected range of weights
 template <typename T>
 SamplableSet<T>::SamplableSet(double min_weight, double max_weight) :
     min_weight_(min_weight),
@@ -119,8 +197,10 @@ SamplableSet<T>::SamplableSet(double min_weight, double max_weight) :
     position_map_(),
     sampling_tree_(number_of_group_),
     propensity_group_vector_(number_of_group_),
+    update_count_vector_(number_of_group_, 0),
     iterator_(),
-    iterator_group_index_(0)
+    iterator_group_index_(0),
+    first_group_(0)
 {
     //Initialize max propensity vector
     if (number_of_group_ > 2)
@@ -136,6 +216,8 @@ SamplableSet<T>::SamplableSet(double min_weight, double max_weight) :
 //Copy constructor
 template <typename T>
 SamplableSet<T>::SamplableSet(const SamplableSet<T>& s) :
+    min_weight_(s.min_weight_),
+    max_weight_(s.max_weight_),
     random_01_(0.,1.),
     hash_(s.hash_),
     number_of_group_(s.number_of_group_),
@@ -143,32 +225,350 @@ SamplableSet<T>::SamplableSet(const SamplableSet<T>& s) :
     position_map_(s.position_map_),
     sampling_tree_(s.sampling_tree_),
     propensity_group_vector_(s.propensity_group_vector_),
+    update_count_vector_(s.update_count_vector_),
     iterator_(),
-    iterator_group_index_(0)
+    iterator_group_index_(0),
+    first_group_(s.first_group_)
 {
 }
 
-//throw a invalid_argument error if the weight is out of bounds
+//Move constructor; the iterator is reset
+template <typename T>
+SamplableSet<T>::SamplableSet(SamplableSet<T>&& s) :
+    min_weight_(s.min_weight_),
+    max_weight_(s.max_weight_),
+    random_01_(0.,1.),
+    hash_(s.hash_),
+    number_of_group_(s.number_of_group_),
+    max_propensity_vector_(std::move(s.max_propensity_vector_)),
+    position_map_(std::move(s.position_map_)),
+    sampling_tree_(std::move(s.sampling_tree_)),
+    propensity_group_vector_(std::move(s.propensity_group_vector_)),
+    update_count_vector_(std::move(s.update_count_vector_)),
+    iterator_(),
+    iterator_group_index_(0),
+    first_group_(s.first_group_)
+{
+}
+
+//Copy assignment operator
+template <typename T>
+SamplableSet<T>& SamplableSet<T>::operator=(const SamplableSet<T>& s)
+{
+    if (this != &s)
+    {
+        *this = SamplableSet<T>(s);
+    }
+    return *this;
+}
+
+//Move assignment operator; the iterator is reset
+template <typename T>
+SamplableSet<T>& SamplableSet<T>::operator=(SamplableSet<T>&& s)
+{
+    if (this != &s)
+    {
+        min_weight_ = s.min_weight_;
+        max_weight_ = s.max_weight_;
+        hash_ = s.hash_;
+        number_of_group_ = s.number_of_group_;
+        max_propensity_vector_ = std::move(s.max_propensity_vector_);
+        position_map_ = std::move(s.position_map_);
+        sampling_tree_ = std::move(s.sampling_tree_);
+        propensity_group_vector_ = std::move(s.propensity_group_vector_);
+        update_count_vector_ = std::move(s.update_count_vector_);
+        iterator_ = typename PropensityGroup::iterator();
+        iterator_group_index_ = 0;
+        first_group_ = s.first_group_;
+    }
+    return *this;
+}
+
+//throw a invalid_argument error if the weight is not positive and finite
 template <typename T>
 void SamplableSet<T>::weight_checkup(double weight) const
 {
-    if (weight < min_weight_ or weight > max_weight_)
+    if (not (weight > 0) or std::isinf(weight))
     {
         throw std::invalid_argument("Weight out of bounds");
     }
 }
 
+//add the groups needed for a weight
+template <typename T>
+void SamplableSet<T>::cover_group(std::int64_t group, double weight)
+{
+    std::int64_t last_group = first_group_ + number_of_group_ - 1;
+    if (group < first_group_ or group > last_group)
+    {
+        if (empty())
+        {
+            //start over with a single group
+            max_weight_ = get_group_bound(group);
+            rebuild_groups(group, group);
+        }
+        else
+        {
+            if (group > last_group)
+            {
+                max_weight_ = get_group_bound(group);
+            }
+            rebuild_groups(std::min(group, first_group_),
+                    std::max(group, last_group));
+        }
+    }
+    else if (weight > max_weight_)
+    {
+        //the last group is bounded by the maximal weight at construction
+        max_weight_ = get_group_bound(last_group);
+        max_propensity_vector_.back() = max_weight_;
+    }
+}
+
+//remove the empty groups at both ends when they are as many as the
+//groups in between
+template <typename T>
+void SamplableSet<T>::shrink_groups()
+{
+    if (empty())
+    {
+        return;
+    }
+    std::int64_t first_empty = 0;
+    while (propensity_group_vector_[first_empty].empty())
+    {
+        first_empty += 1;
+    }
+    std::int64_t last_empty = 0;
+    while (propensity_group_vector_[number_of_group_ - 1 - last_empty].empty())
+    {
+        last_empty += 1;
+    }
+    if (first_empty + last_empty >= number_of_group_ - first_empty - last_empty)
+    {
+        std::int64_t last_group = first_group_ + number_of_group_ - 1 - last_empty;
+        if (last_empty > 0)
+        {
+            max_weight_ = get_group_bound(last_group);
+        }
+        rebuild_groups(first_group_ + first_empty, last_group);
+    }
+}
+
+//change the range of groups; the groups outside the range must be empty
+template <typename T>
+void SamplableSet<T>::rebuild_groups(std::int64_t first_group,
+        std::int64_t last_group)
+{
+    unsigned int number_of_group = last_group - first_group + 1;
+    std::vector<PropensityGroup> propensity_group_vector(number_of_group);
+    std::vector<std::size_t> update_count_vector(number_of_group, 0);
+    BinaryTree sampling_tree(number_of_group);
+    for (GroupIndex group_index = 0; group_index < number_of_group_; group_index++)
+    {
+        std::int64_t group = first_group_ + group_index;
+        if (group >= first_group and group <= last_group)
+        {
+            GroupIndex new_group_index = group - first_group;
+            sampling_tree.update_value(new_group_index,
+                    sampling_tree_.get_leaf_value(group_index));
+            propensity_group_vector[new_group_index] =
+                std::move(propensity_group_vector_[group_index]);
+            update_count_vector[new_group_index] =
+                update_count_vector_[group_index];
+        }
+    }
+    first_group_ = first_group;
+    number_of_group_ = number_of_group;
+    propensity_group_vector_ = std::move(propensity_group_vector);
+    update_count_vector_ = std::move(update_count_vector);
+    sampling_tree_ = std::move(sampling_tree);
+    sampling_tree_.reset_current_node();
+    max_propensity_vector_.resize(number_of_group);
+    for (GroupIndex group_index = 0; group_index < number_of_group; group_index++)
+    {
+        max_propensity_vector_[group_index] = get_group_bound(first_group + group_index);
+    }
+    max_propensity_vector_.back() = std::min(max_propensity_vector_.back(), max_weight_);
+    min_weight_ = std::ldexp(hash_.get_propensity_min(), first_group);
+    iterator_group_index_ = 0;
+}
+
+//update the total weight of a group; the total is recomputed exactly once
+//the group has seen more updates than elements, which bounds the rounding
+//error accumulated in the tree at an amortized O(1) cost
+template <typename T>
+void SamplableSet<T>::update_group_weight(GroupIndex group_index,
+        double variation)
+{
+    std::size_t& update_count = update_count_vector_[group_index];
+    std::size_t group_size = propensity_group_vector_[group_index].size();
+    update_count += 1;
+    if (group_size == 0)
+    {
+        sampling_tree_.set_value(group_index, 0.);
+        update_count = 0;
+    }
+    else if (update_count > std::max(group_size, MIN_UPDATE_COUNT))
+    {
+        sampling_tree_.set_value(group_index, exact_group_weight(group_index));
+        update_count = 0;
+    }
+    else
+    {
+        sampling_tree_.update_value(group_index, variation);
+    }
+}
+
+//compensated (Neumaier) sum of the weights in a group
+template <typename T>
+double SamplableSet<T>::exact_group_weight(GroupIndex group_index) const
+{
+    double sum = 0.;
+    double compensation = 0.;
+    for (const auto& element_weight_pair : propensity_group_vector_[group_index])
+    {
+        double weight = element_weight_pair.second;
+        double new_sum = sum + weight;
+        if (std::abs(sum) >= std::abs(weight))
+        {
+            compensation += (sum - new_sum) + weight;
+        }
+        else
+        {
+            compensation += (weight - new_sum) + sum;
+        }
+        sum = new_sum;
+    }
+    return sum + compensation;
+}
+
+//replace the content of the set in bulk; the total of each group is
+//computed once instead of updating the tree for each element
+template <typename T>
+void SamplableSet<T>::assign(
+        const std::vector<std::pair<T,double> >& element_weight_vector)
+{
+    clear();
+    position_map_.reserve(element_weight_vector.size());
+    for (const auto& element_weight_pair : element_weight_vector)
+    {
+        const T& element = element_weight_pair.first;
+        double weight = element_weight_pair.second;
+        weight_checkup(weight);
+        //keep the first weight of an element, as insert does
+        if (position_map_.find(element) == position_map_.end())
+        {
+            std::int64_t group = hash_.group(weight);
+            cover_group(group, weight);
+            GroupIndex group_index = group - first_group_;
+            position_map_[element] = SSetPosition(group + GROUP_BIAS,
+                    propensity_group_vector_[group_index].size());
+            propensity_group_vector_[group_index].emplace_back(element, weight);
+        }
+    }
+    for (GroupIndex group_index = 0; group_index < number_of_group_; group_index++)
+    {
+        if (not propensity_group_vector_[group_index].empty())
+        {
+            sampling_tree_.set_value(group_index, exact_group_weight(group_index));
+        }
+    }
+    sampling_tree_.reset_current_node();
+}
+
+//write the groups and their elements in order, so that a loaded set
+//samples exactly as this one; requires trivially copyable elements
+template <typename T>
+void SamplableSet<T>::save(std::ostream& stream) const
+{
+    write_binary(stream, hash_.get_propensity_min());
+    write_binary(stream, hash_.get_propensity_max());
+    write_binary(stream, min_weight_);
+    write_binary(stream, max_weight_);
+    write_binary(stream, first_group_);
+    write_binary(stream, std::uint64_t(number_of_group_));
+    std::vector<T> element_vector;
+    std::vector<double> weight_vector;
+    for (GroupIndex group_index = 0; group_index < number_of_group_; group_index++)
+    {
+        element_vector.clear();
+        weight_vector.clear();
+        for (const auto& element_weight_pair : propensity_group_vector_[group_index])
+        {
+            element_vector.push_back(element_weight_pair.first);
+            weight_vector.push_back(element_weight_pair.second);
+        }
+        write_binary(stream, std::uint64_t(update_count_vector_[group_index]));
+        write_binary(stream, sampling_tree_.get_leaf_value(group_index));
+        write_binary_vector(stream, element_vector);
+        write_binary_vector(stream, weight_vector);
+    }
+}
+
+//replace the content of the set by a set written with save
+template <typename T>
+void SamplableSet<T>::load(std::istream& stream)
+{
+    double propensity_min = read_binary<double>(stream);
+    double propensity_max = read_binary<double>(stream);
+    hash_ = HashPropensity(propensity_min, propensity_max);
+    read_binary(stream, min_weight_);
+    read_binary(stream, max_weight_);
+    read_binary(stream, first_group_);
+    number_of_group_ = read_binary<std::uint64_t>(stream);
+    if (number_of_group_ == 0)
+    {
+        throw std::runtime_error("Invalid number of groups in binary stream");
+    }
+    position_map_.clear();
+    sampling_tree_ = BinaryTree(number_of_group_);
+    propensity_group_vector_.assign(number_of_group_, PropensityGroup());
+    update_count_vector_.assign(number_of_group_, 0);
+    max_propensity_vector_.resize(number_of_group_);
+    std::vector<T> element_vector;
+    std::vector<double> weight_vector;
+    for (GroupIndex group_index = 0; group_index < number_of_group_; group_index++)
+    {
+        update_count_vector_[group_index] = read_binary<std::uint64_t>(stream);
+        double group_weight = read_binary<double>(stream);
+        read_binary_vector(stream, element_vector);
+        read_binary_vector(stream, weight_vector);
+        if (element_vector.size() != weight_vector.size())
+        {
+            throw std::runtime_error("Inconsistent group in binary stream");
+        }
+        PropensityGroup& group = propensity_group_vector_[group_index];
+        group.reserve(element_vector.size());
+        for (InGroupIndex in_group_index = 0; in_group_index < element_vector.size();
+                in_group_index++)
+        {
+            group.emplace_back(element_vector[in_group_index],
+                    weight_vector[in_group_index]);
+            position_map_[element_vector[in_group_index]] = SSetPosition(
+                    first_group_ + group_index + GROUP_BIAS, in_group_index);
+        }
+        sampling_tree_.set_value(group_index, group_weight);
+        max_propensity_vector_[group_index] = get_group_bound(first_group_ + group_index);
+    }
+    max_propensity_vector_.back() = std::min(max_propensity_vector_.back(), max_weight_);
+    sampling_tree_.reset_current_node();
+    iterator_group_index_ = 0;
+}
+
 //sample an element according to its weight
 template <typename T>
 std::optional<std::pair<T,double> > SamplableSet<T>::sample() const
 {
     if (not empty())
     {
+        SSET_PROFILE_ADD(sample_calls, 1);
         GroupIndex group_index = sampling_tree_.get_leaf_index(random_01_(gen_));
         bool element_not_chosen = true;
         InGroupIndex in_group_index;
         while (element_not_chosen)
         {
+            SSET_PROFILE_ADD(rejection_trials, 1);
             in_group_index = floor(random_01_(gen_)*propensity_group_vector_.at(
                         group_index).size());
 
@@ -195,11 +595,13 @@ std::optional<std::pair<T,double> > SamplableSet<T>::sample_ext_RNG(ExtRNG& gen)
 {
     if (not empty())
     {
+        SSET_PROFILE_ADD(sample_calls, 1);
         GroupIndex group_index = sampling_tree_.get_leaf_index(random_01_(gen));
         bool element_not_chosen = true;
         InGroupIndex in_group_index;
         while (element_not_chosen)
         {
+            SSET_PROFILE_ADD(rejection_trials, 1);
             in_group_index = floor(random_01_(gen)*propensity_group_vector_.at(
                         group_index).size());
 
@@ -219,6 +621,204 @@ std::optional<std::pair<T,double> > SamplableSet<T>::sample_ext_RNG(ExtRNG& gen)
     }
 }
 
+//sample n elements according to their weight, with replacement; the
+//sample is appended, grouped by propensity group
+template <typename T>
+void SamplableSet<T>::sample_n(std::size_t n, std::vector<T>& sample) const
+{
+    sample_n_ext_RNG(n, sample, gen_);
+}
+
+//same as sample_n using an external RNG; the number of elements drawn from
+//each group is obtained with one multinomial split down the tree, then each
+//group is sampled by rejection
+template <typename T>
+template <typename ExtRNG>
+void SamplableSet<T>::sample_n_ext_RNG(std::size_t n, std::vector<T>& sample,
+        ExtRNG& gen) const
+{
+    if (empty() or n == 0)
+    {
+        return;
+    }
+    std::vector<std::size_t> group_count(number_of_group_, 0);
+    sampling_tree_.reset_current_node();
+    multinomial_split(n, group_count, gen);
+    sampling_tree_.reset_current_node();
+
+    std::uniform_real_distribution<double> random_01(0.,1.);
+    sample.reserve(sample.size() + n);
+    std::size_t redrawn_count = 0; //drawn in groups left with rounding errors
+    for (GroupIndex group_index = 0; group_index < number_of_group_;
+            group_index++)
+    {
+        const PropensityGroup& group = propensity_group_vector_[group_index];
+        double max_propensity = max_propensity_vector_[group_index];
+        std::size_t count = group_count[group_index];
+        if (group.empty())
+        {
+            redrawn_count += count;
+            continue;
+        }
+        SSET_PROFILE_ADD(sample_calls, count);
+        while (count > 0)
+        {
+            SSET_PROFILE_ADD(rejection_trials, 1);
+            const std::pair<T,double>& element_weight_pair =
+                group[std::size_t(random_01(gen)*group.size())];
+            if (random_01(gen)*max_propensity < element_weight_pair.second)
+            {
+                sample.push_back(element_weight_pair.first);
+                count -= 1;
+            }
+        }
+    }
+    sample_n_ext_RNG(redrawn_count, sample, gen);
+}
+
+//split n draws between the leaves below the current node of the tree
+template <typename T>
+template <typename ExtRNG>
+void SamplableSet<T>::multinomial_split(std::size_t n,
+        std::vector<std::size_t>& group_count, ExtRNG& gen) const
+{
+    if (n == 0)
+    {
+        return;
+    }
+    if (sampling_tree_.is_leaf())
+    {
+        group_count[sampling_tree_.get_leaf_index()] += n;
+        return;
+    }
+    double value_left = std::max(sampling_tree_.get_value_left(), 0.);
+    double value_right = std::max(sampling_tree_.get_value_right(), 0.);
+    std::size_t n_left = 0;
+    if (value_right <= 0)
+    {
+        n_left = n;
+    }
+    else if (value_left > 0)
+    {
+        std::binomial_distribution<std::size_t> binomial(n,
+                value_left/(value_left + value_right));
+        n_left = binomial(gen);
+    }
+    sampling_tree_.move_down_left();
+    multinomial_split(n_left, group_count, gen);
+    sampling_tree_.move_up();
+    sampling_tree_.move_down_right();
+    multinomial_split(n - n_left, group_count, gen);
+    sampling_tree_.move_up();
+}
+
+//sample n distinct elements, each draw being proportional to the weight
+//among the elements not drawn yet; if n is larger than the size of the set,
+//all elements are sampled
+template <typename T>
+void SamplableSet<T>::sample_n_without_replacement(std::size_t n,
+        std::vector<T>& sample) const
+{
+    sample_n_without_replacement_ext_RNG(n, sample, gen_);
+}
+
+//same as sample_n_without_replacement using an external RNG; batches of
+//draws with replacement are repeated, discarding the elements already drawn
+template <typename T>
+template <typename ExtRNG>
+void SamplableSet<T>::sample_n_without_replacement_ext_RNG(std::size_t n,
+        std::vector<T>& sample, ExtRNG& gen) const
+{
+    if (n >= size())
+    {
+        for (const PropensityGroup& group : propensity_group_vector_)
+        {
+            for (const std::pair<T,double>& element_weight_pair : group)
+            {
+                sample.push_back(element_weight_pair.first);
+            }
+        }
+        return;
+    }
+    std::unordered_set<T> drawn_set;
+    std::vector<T> batch;
+    while (drawn_set.size() < n)
+    {
+        batch.clear();
+        sample_n_ext_RNG(n - drawn_set.size(), batch, gen);
+        for (const T& element : batch)
+        {
+            if (drawn_set.insert(element).second)
+            {
+                sample.push_back(element);
+            }
+        }
+    }
+}
+
+//select each element independently with probability(weight), where
+//probability is a non-decreasing function. In each group, candidates are
+//found by geometric skipping with the largest probability of the group, then
+//accepted with the ratio of probabilities, hence the cost is proportional to
+//the number of selected elements (plus the number of groups).
+template <typename T>
+template <typename Func>
+void SamplableSet<T>::sample_independent(Func probability,
+        std::vector<T>& sample) const
+{
+    sample_independent_ext_RNG(probability, sample, gen_);
+}
+
+//same as sample_independent using an external RNG; the elements can be split
+//in number_of_parts disjoint parts (a slice of each group) that can be
+//processed concurrently, each with its own RNG
+template <typename T>
+template <typename Func, typename ExtRNG>
+void SamplableSet<T>::sample_independent_ext_RNG(Func probability,
+        std::vector<T>& sample, ExtRNG& gen, unsigned int part,
+        unsigned int number_of_parts) const
+{
+    std::uniform_real_distribution<double> random_01(0.,1.);
+    for (GroupIndex group_index = 0; group_index < number_of_group_;
+            group_index++)
+    {
+        const PropensityGroup& group = propensity_group_vector_[group_index];
+        double max_probability = probability(
+                max_propensity_vector_[group_index]);
+        if (group.empty() or max_probability <= 0)
+        {
+            continue;
+        }
+        std::size_t first = (group.size()*part)/number_of_parts;
+        std::size_t last = (group.size()*(part+1))/number_of_parts;
+        if (max_probability >= 1)
+        {
+            //no skipping possible, visit all elements
+            for (std::size_t i = first; i < last; i++)
+            {
+                if (random_01(gen) < probability(group[i].second))
+                {
+                    sample.push_back(group[i].first);
+                }
+            }
+            continue;
+        }
+        double log_complement = log1p(-max_probability);
+        double index = first + floor(log(1. - random_01(gen))/log_complement);
+        while (index < last)
+        {
+            const std::pair<T,double>& element_weight_pair =
+                group[std::size_t(index)];
+            if (random_01(gen)*max_probability <
+                    probability(element_weight_pair.second))
+            {
+                sample.push_back(element_weight_pair.first);
+            }
+            index += 1. + floor(log(1. - random_01(gen))/log_complement);
+        }
+    }
+}
+
 //get the weight of an element if it exists
 template <typename T>
 std::optional<double> SamplableSet<T>::get_weight(const T& element) const
@@ -226,7 +826,8 @@ std::optional<double> SamplableSet<T>::get_weight(const T& element) const
     if(count(element))
     {
         const SSetPosition& position = position_map_.at(element);
-        return (propensity_group_vector_[position.first][position.second]).second;
+        return (propensity_group_vector_[get_group_index(position)][
+                position.second]).second;
     }
     else
     {
@@ -243,13 +844,15 @@ void SamplableSet<T>::insert(const T& element, double weight)
     //insert element only if not present
     if (position_map_.find(element) == position_map_.end())
     {
-        GroupIndex group_index = hash_(weight);
+        std::int64_t group = hash_.group(weight);
+        cover_group(group, weight);
+        GroupIndex group_index = group - first_group_;
         InGroupIndex in_group_index =
             propensity_group_vector_[group_index].size();
         propensity_group_vector_[group_index].push_back(
                 std::make_pair(element,weight));
-        position_map_[element] = SSetPosition(group_index, in_group_index);
-        sampling_tree_.update_value(group_index, weight);
+        position_map_[element] = SSetPosition(group + GROUP_BIAS, in_group_index);
+        update_group_weight(group_index, weight);
     }
 }
 
@@ -258,6 +861,7 @@ void SamplableSet<T>::insert(const T& element, double weight)
 template <typename T>
 void SamplableSet<T>::set_weight(const T& element, double weight)
 {
+    SSET_PROFILE_ADD(set_weight_calls, 1);
     weight_checkup(weight);
     erase(element);
     insert(element, weight);
@@ -271,18 +875,23 @@ void SamplableSet<T>::erase(const T& element)
     if (count(element))
     {
         const SSetPosition& position = position_map_.at(element);
+        GroupIndex group_index = get_group_index(position);
+        PropensityGroup& group = propensity_group_vector_[group_index];
         //create alias for element and its weight pair
-        std::pair<T, double>& element_weight_pair =
-            propensity_group_vector_[position.first][position.second];
-        sampling_tree_.update_value(position.first, -element_weight_pair.second);
+        std::pair<T, double>& element_weight_pair = group[position.second];
+        double weight = element_weight_pair.second;
         //gives position to last element of propensity group and swap
-        position_map_[
-            (propensity_group_vector_[position.first].back()).first] = position;
-        std::swap(element_weight_pair,
-                propensity_group_vector_[position.first].back());
+        position_map_[(group.back()).first] = position;
+        std::swap(element_weight_pair, group.back());
         //remove
-        propensity_group_vector_[position.first].pop_back();
+        group.pop_back();
         position_map_.erase(element);
+        update_group_weight(group_index, -weight);
+        if (group.empty() and
+                (group_index == 0 or group_index == number_of_group_ - 1))
+        {
+            shrink_groups();
+        }
     }
 }
 
@@ -292,6 +901,7 @@ void SamplableSet<T>::clear()
 {
     sampling_tree_.clear();
     position_map_.clear();
+    std::fill(update_count_vector_.begin(), update_count_vector_.end(), 0);
     iterator_group_index_ = 0;
     for (auto &group_vector : propensity_group_vector_)
     {
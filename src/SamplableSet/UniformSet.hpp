@@ -0,0 +1,256 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef UNIFORMSET_HPP_
+#define UNIFORMSET_HPP_
+
+#include "SamplableSet.hpp"
+#include <vector>
+#include <random>
+#include <optional>
+#include <limits>
+#include <unordered_set>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace sset
+{//start of namespace sset
+
+
+/*
+ * Set of integral elements of equal weight 1, stored in a dense array;
+ * sampling is uniform and O(1). It has the same interface as SamplableSet
+ * for the event sets whose weights do not change (e.g. recovery events).
+ */
+template <class T>
+class UniformSet : public BaseSamplableSet
+{
+    static_assert(std::is_integral<T>::value, "UniformSet requires integral elements");
+public:
+    //Default constructor
+    UniformSet() : element_vector_(), position_vector_() {}
+
+    //Accessors
+    std::size_t size() const {return element_vector_.size();}
+    bool empty() const {return element_vector_.empty();}
+    std::size_t count(const T& element) const
+        {return std::size_t(element) < position_vector_.size() and
+            position_vector_[element] != NPOS;}
+    double total_weight() const {return element_vector_.size();}
+    std::optional<double> get_weight(const T& element) const
+        {return count(element) ? std::optional<double>(1.) : std::nullopt;}
+    std::optional<std::pair<T,double> > sample() const
+        {return sample_ext_RNG(gen_);}
+    template <typename ExtRNG>
+    std::optional<std::pair<T,double> > sample_ext_RNG(ExtRNG& gen) const;
+    void sample_n(std::size_t n, std::vector<T>& sample) const
+        {sample_n_ext_RNG(n, sample, gen_);}
+    template <typename ExtRNG>
+    void sample_n_ext_RNG(std::size_t n, std::vector<T>& sample, ExtRNG& gen) const;
+    void sample_n_without_replacement(std::size_t n, std::vector<T>& sample) const
+        {sample_n_without_replacement_ext_RNG(n, sample, gen_);}
+    template <typename ExtRNG>
+    void sample_n_without_replacement_ext_RNG(std::size_t n, std::vector<T>& sample,
+            ExtRNG& gen) const;
+    template <typename Func>
+    void sample_independent(Func probability, std::vector<T>& sample) const
+        {sample_independent_ext_RNG(probability, sample, gen_);}
+    template <typename Func, typename ExtRNG>
+    void sample_independent_ext_RNG(Func probability, std::vector<T>& sample,
+            ExtRNG& gen, unsigned int part = 0,
+            unsigned int number_of_parts = 1) const;
+    void save(std::ostream& stream) const
+        {write_binary_vector(stream, element_vector_);}
+
+    //Mutators
+    void insert(const T& element, double weight = 1.);
+    void erase(const T& element);
+    void clear();
+    void load(std::istream& stream);
+
+private:
+    //positions are 32-bit to halve the memory of the index
+    static constexpr std::uint32_t NPOS = std::numeric_limits<std::uint32_t>::max();
+    std::vector<T> element_vector_;
+    std::vector<std::uint32_t> position_vector_; //indexed by element
+};
+
+
+//sample an element uniformly using an external RNG
+template <typename T>
+template <typename ExtRNG>
+std::optional<std::pair<T,double> > UniformSet<T>::sample_ext_RNG(ExtRNG& gen) const
+{
+    if (empty())
+    {
+        return std::nullopt;
+    }
+    std::uniform_int_distribution<std::size_t> random_index(0, size() - 1);
+    return std::make_pair(element_vector_[random_index(gen)], 1.);
+}
+
+//sample n elements uniformly with replacement; the sample is appended
+template <typename T>
+template <typename ExtRNG>
+void UniformSet<T>::sample_n_ext_RNG(std::size_t n, std::vector<T>& sample,
+        ExtRNG& gen) const
+{
+    if (empty())
+    {
+        return;
+    }
+    std::uniform_int_distribution<std::size_t> random_index(0, size() - 1);
+    sample.reserve(sample.size() + n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        sample.push_back(element_vector_[random_index(gen)]);
+    }
+}
+
+//sample n distinct elements uniformly; if n is larger than the size of the
+//set, all elements are sampled
+template <typename T>
+template <typename ExtRNG>
+void UniformSet<T>::sample_n_without_replacement_ext_RNG(std::size_t n,
+        std::vector<T>& sample, ExtRNG& gen) const
+{
+    if (n >= size())
+    {
+        sample.insert(sample.end(), element_vector_.begin(), element_vector_.end());
+        return;
+    }
+    //Floyd's algorithm
+    std::unordered_set<std::size_t> index_set;
+    for (std::size_t j = size() - n; j < size(); j++)
+    {
+        std::uniform_int_distribution<std::size_t> random_index(0, j);
+        std::size_t index = random_index(gen);
+        if (not index_set.insert(index).second)
+        {
+            index_set.insert(j);
+            index = j;
+        }
+        sample.push_back(element_vector_[index]);
+    }
+}
+
+//sample each element independently with probability(1.); the elements are
+//skipped geometrically, and can be split in number_of_parts disjoint parts
+template <typename T>
+template <typename Func, typename ExtRNG>
+void UniformSet<T>::sample_independent_ext_RNG(Func probability,
+        std::vector<T>& sample, ExtRNG& gen, unsigned int part,
+        unsigned int number_of_parts) const
+{
+    double p = probability(1.);
+    std::size_t first = (size()*part)/number_of_parts;
+    std::size_t last = (size()*(part+1))/number_of_parts;
+    if (p <= 0)
+    {
+        return;
+    }
+    if (p >= 1)
+    {
+        sample.insert(sample.end(), element_vector_.begin() + first,
+                element_vector_.begin() + last);
+        return;
+    }
+    std::uniform_real_distribution<double> random_01(0.,1.);
+    double log_complement = log1p(-p);
+    double index = first + floor(log(1. - random_01(gen))/log_complement);
+    while (index < last)
+    {
+        sample.push_back(element_vector_[std::size_t(index)]);
+        index += 1. + floor(log(1. - random_01(gen))/log_complement);
+    }
+}
+
+//insert an element; the weight must be 1
+template <typename T>
+void UniformSet<T>::insert(const T& element, double weight)
+{
+    if (weight != 1.)
+    {
+        throw std::invalid_argument("Weight must be 1 in a UniformSet");
+    }
+    if (std::size_t(element) >= position_vector_.size())
+    {
+        position_vector_.resize(std::size_t(element) + 1, NPOS);
+    }
+    if (position_vector_[element] == NPOS)
+    {
+        if (element_vector_.size() >= NPOS)
+        {
+            throw std::length_error("Too many elements in a UniformSet");
+        }
+        position_vector_[element] = element_vector_.size();
+        element_vector_.push_back(element);
+    }
+}
+
+//erase an element by swapping it with the last one
+template <typename T>
+void UniformSet<T>::erase(const T& element)
+{
+    if (count(element))
+    {
+        std::uint32_t position = position_vector_[element];
+        T last_element = element_vector_.back();
+        element_vector_[position] = last_element;
+        position_vector_[last_element] = position;
+        element_vector_.pop_back();
+        position_vector_[element] = NPOS;
+    }
+}
+
+//remove all elements
+template <typename T>
+void UniformSet<T>::clear()
+{
+    for (const T& element : element_vector_)
+    {
+        position_vector_[element] = NPOS;
+    }
+    element_vector_.clear();
+}
+
+//replace the content of the set by a set written with save; the order of
+//the elements is kept
+template <typename T>
+void UniformSet<T>::load(std::istream& stream)
+{
+    clear();
+    std::vector<T> element_vector;
+    read_binary_vector(stream, element_vector);
+    for (const T& element : element_vector)
+    {
+        insert(element);
+    }
+}
+
+}//end of namespace sset
+
+#endif /* UNIFORMSET_HPP_ */
@@ -0,0 +1,299 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "WeightedContinuousSIR.hpp"
+#include <exception>
+#include <cmath>
+#include <optional>
+
+using namespace std;
+
+namespace fastsir
+{//start of namespace fastsir
+
+//constructor of the class
+WeightedContinuousSIR::WeightedContinuousSIR(const EdgeList& edge_list,
+        const vector<double>& edge_weight, double recovery_rate,
+        const vector<double>& infection_rate, double weight_step,
+        bool directed):
+    WeightedContinuousSIR(make_shared<const Network>(edge_list, edge_weight, directed),
+            recovery_rate, infection_rate, weight_step)
+{
+}
+
+//constructor of the class provided the network, which must be weighted
+WeightedContinuousSIR::WeightedContinuousSIR(shared_ptr<const Network> network,
+        double recovery_rate, const vector<double>& infection_rate,
+        double weight_step):
+    ContinuousSIR(move(network), recovery_rate, infection_rate),
+    weight_step_(weight_step),
+    infected_weight_vector_(network_->size(), 0.)
+{
+    if (not network_->is_weighted())
+    {
+        throw invalid_argument("The network must be weighted");
+    }
+    if (infection_rate.empty())
+    {
+        throw invalid_argument("Infection rate must have at least one value");
+    }
+    if (not (weight_step > 0) or isinf(weight_step))
+    {
+        throw invalid_argument("Weight step must be positive");
+    }
+}
+
+//set new infection rates; the event set is rebuilt in a single pass over
+//the susceptible nodes with infected neighbors
+void WeightedContinuousSIR::set_infection_rate(const vector<double>& infection_rate)
+{
+    check_infection_rate(infection_rate);
+    infection_rate_ = infection_rate;
+    vector<pair<Node,double>> element_weight_vector;
+    for (Node node : get_nodes_at_risk())
+    {
+        double rate = get_weighted_infection_rate(infected_weight_vector_[node]);
+        if (rate > 0)
+        {
+            element_weight_vector.emplace_back(node, rate);
+        }
+    }
+    infection_event_set_.assign(element_weight_vector);
+}
+
+void WeightedContinuousSIR::check_infection_rate(const vector<double>& infection_rate) const
+{
+    if (infection_rate.empty())
+    {
+        throw invalid_argument("Infection rate must have at least one value");
+    }
+    for (double rate : infection_rate)
+    {
+        if (not (rate >= 0))
+        {
+            throw invalid_argument("Infection rate must be non-negative");
+        }
+    }
+}
+
+//get the infection rate for a summed weight of infected neighbors
+double WeightedContinuousSIR::get_weighted_infection_rate(double infected_weight) const
+{
+    size_t last = infection_rate_.size() - 1;
+    if (last == 0)
+    {
+        return infection_rate_[0];
+    }
+    double x = infected_weight/weight_step_;
+    size_t index = x < last ? size_t(x) : last - 1;
+    double rate = infection_rate_[index] + (x - index)*(
+            infection_rate_[index+1] - infection_rate_[index]);
+    return max(rate, 0.);
+}
+
+//update the infected neighbors of a susceptible node and its infection
+//rate; weight is the weight of the edge to the node of the event
+void WeightedContinuousSIR::update_infection_rate(Node node,
+        const Event& event, double weight)
+{
+    Node other_node = event.first;
+    Action action = event.second;
+
+    vector<Node>& infected_neighbors = infected_neighbors_vector_[node];
+    InfectedNeighborPosition& infected_neighbor_position =
+        infected_neighbor_position_vector_[node];
+
+    if (action == RECOVERY)
+    {
+        size_t position = infected_neighbor_position[other_node];
+
+        swap(infected_neighbors[position],infected_neighbors.back());
+
+        //also, update the position of the node in the back
+        Node back_node = infected_neighbors[position];
+        infected_neighbor_position[back_node] = position;
+        //pop
+        infected_neighbors.pop_back();
+        infected_neighbor_position.erase(other_node);
+        infected_weight_vector_[node] -= weight;
+    }
+    else if (action == INFECTION)
+    {
+        infected_neighbor_position[other_node] = infected_neighbors.size();
+        infected_neighbors.push_back(other_node);
+        infected_weight_vector_[node] += weight;
+    }
+
+    //no rounding error is left when the last infected neighbor recovers
+    if (infected_neighbors.empty())
+    {
+        infected_weight_vector_[node] = 0.;
+        infection_event_set_.erase(node);
+        return;
+    }
+
+    //update event set with new rate
+    double new_rate = get_weighted_infection_rate(infected_weight_vector_[node]);
+    if (new_rate > 0)
+    {
+        infection_event_set_.set_weight(node,new_rate);
+    }
+    else
+    {
+        infection_event_set_.erase(node);
+    }
+}
+
+//infect a node
+void WeightedContinuousSIR::infect(Node node)
+{
+    if (state_vector_[node] == S)
+    {
+        infection_event_set_.erase(node);
+        state_vector_[node] = I;
+        infected_node_set_.insert(node);
+        Event event = make_pair(node,INFECTION);
+        Range<Node> adjacent_nodes = network_->adjacent_nodes(node);
+        Range<double> edge_weights = network_->edge_weights(node);
+        FASTSIR_PROFILE_ADD(neighbor_visits, adjacent_nodes.size());
+        for (size_t i = 0; i < adjacent_nodes.size(); i++)
+        {
+            if (state_vector_[adjacent_nodes[i]] == S)
+            {
+                update_infection_rate(adjacent_nodes[i], event, edge_weights[i]);
+            }
+        }
+        //create a recovery event for the node
+        recovery_event_set_.insert(node, 1.);
+        //clear infected neighbors
+        infected_neighbors_vector_[node].clear();
+        infected_neighbor_position_vector_[node].clear();
+        infected_weight_vector_[node] = 0.;
+    }
+    else
+    {
+        throw runtime_error("Infection attempt: the node is not susceptible");
+    }
+}
+
+//recover a node
+void WeightedContinuousSIR::recover(Node node)
+{
+    if (state_vector_[node] == I)
+    {
+        state_vector_[node] = R;
+        infected_node_set_.erase(node);
+        recovered_node_set_.insert(node);
+        Event event = make_pair(node,RECOVERY);
+        Range<Node> adjacent_nodes = network_->adjacent_nodes(node);
+        Range<double> edge_weights = network_->edge_weights(node);
+        FASTSIR_PROFILE_ADD(neighbor_visits, adjacent_nodes.size());
+        for (size_t i = 0; i < adjacent_nodes.size(); i++)
+        {
+            if (state_vector_[adjacent_nodes[i]] == S)
+            {
+                update_infection_rate(adjacent_nodes[i], event, edge_weights[i]);
+            }
+        }
+        //erase the recovery event for the node
+        recovery_event_set_.erase(node);
+    }
+    else
+    {
+        throw runtime_error("Recovery attempt: the node is not infected");
+    }
+}
+
+//add the infection events to the transmission tree; the infector is an
+//infected (in-)neighbor chosen in proportion to the weight of its edge
+void WeightedContinuousSIR::update_transmission_tree(const vector<Event>& event_vector)
+{
+    for (const Event& event : event_vector)
+    {
+        if (event.second != INFECTION)
+        {
+            continue;
+        }
+        Node infectee = event.first;
+        Range<Node> adjacent_nodes = network_->in_adjacent_nodes(infectee);
+        Range<double> edge_weights = network_->in_edge_weights(infectee);
+        double threshold = random_01_(gen_)*infected_weight_vector_[infectee];
+        optional<Node> infector;
+        for (size_t i = 0; i < adjacent_nodes.size(); i++)
+        {
+            if (state_vector_[adjacent_nodes[i]] == I and edge_weights[i] > 0)
+            {
+                infector = adjacent_nodes[i];
+                threshold -= edge_weights[i];
+                if (threshold < 0)
+                {
+                    break;
+                }
+            }
+        }
+        if (not infector)
+        {
+            //all the edges to infected neighbors have zero weight
+            infector = random_infected_neighbor(infectee);
+        }
+        Generation generation = infection_generation_.at(*infector);
+        infection_generation_[infectee] = generation + 1;
+        transmission_tree_.emplace_back(current_time_, generation, *infector,
+                infectee, get_infected_degree(infectee));
+    }
+}
+
+//clear the state; as if all node became susceptible at this time
+void WeightedContinuousSIR::clear()
+{
+    ContinuousSIR::clear();
+    infected_weight_vector_.assign(network_->size(), 0.);
+}
+
+//write the weight step and the infected weights after the state of
+//ContinuousSIR
+void WeightedContinuousSIR::write_state(ostream& stream) const
+{
+    ContinuousSIR::write_state(stream);
+    sset::write_binary(stream, weight_step_);
+    sset::write_binary_vector(stream, infected_weight_vector_);
+}
+
+//read the state written by write_state
+void WeightedContinuousSIR::read_state(istream& stream)
+{
+    if (not network_->is_weighted())
+    {
+        throw runtime_error("The network of the process is not weighted");
+    }
+    ContinuousSIR::read_state(stream);
+    sset::read_binary(stream, weight_step_);
+    sset::read_binary_vector(stream, infected_weight_vector_);
+    if (infected_weight_vector_.size() != network_->size())
+    {
+        throw runtime_error("Inconsistent infected weights in state file");
+    }
+}
+
+}//end of namespace fastsir
@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WEIGHTEDCONTINUOUSSIR_HPP_
+#define WEIGHTEDCONTINUOUSSIR_HPP_
+
+#include "ContinuousSIR.hpp"
+
+namespace fastsir
+{//start of namespace fastsir
+
+
+//class to simulate SIR process on weighted networks; the infection rate of a
+//susceptible node is a function of the summed weight of the edges to its
+//infected neighbors. The function is given at the weights 0, weight_step,
+//2*weight_step, ..., interpolated linearly in between and extrapolated
+//from the last two values beyond (constant for a single value)
+class WeightedContinuousSIR : public ContinuousSIR
+{
+public:
+    //Constructor
+    WeightedContinuousSIR(const EdgeList& edge_list,
+                          const std::vector<double>& edge_weight,
+                          double recovery_rate,
+                          const std::vector<double>& infection_rate,
+                          double weight_step = 1.,
+                          bool directed = false);
+    WeightedContinuousSIR(std::shared_ptr<const Network> network,
+                          double recovery_rate,
+                          const std::vector<double>& infection_rate,
+                          double weight_step = 1.);
+
+    //Accessors
+    double get_infected_weight(Node node) const
+        {return infected_weight_vector_.at(node);}
+    double get_weight_step() const
+        {return weight_step_;}
+
+    //Mutators
+    void set_infection_rate(const std::vector<double>& infection_rate);
+    void clear();
+
+protected:
+    //Members
+    double weight_step_;
+    std::vector<double> infected_weight_vector_; //of susceptible nodes
+
+    //utility functions
+    double get_weighted_infection_rate(double infected_weight) const;
+    void update_infection_rate(Node node, const Event& event, double weight);
+    void check_infection_rate(const std::vector<double>& infection_rate) const;
+
+    void infect(Node node);
+    void recover(Node node);
+    void update_transmission_tree(const std::vector<Event>& event_vector);
+
+    std::string get_model_name() const
+        {return "WeightedContinuousSIR";}
+    std::unique_ptr<BaseContagion> clone() const
+        {return std::make_unique<WeightedContinuousSIR>(*this);}
+    void assign(BaseContagion&& process)
+        {*this = std::move(static_cast<WeightedContinuousSIR&>(process));}
+    void write_state(std::ostream& stream) const;
+    void read_state(std::istream& stream);
+};
+
+}//end of namespace fastsir
+
+#endif /* WEIGHTEDCONTINUOUSSIR_HPP_ */
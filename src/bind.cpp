@@ -27,13 +27,60 @@
 #include <BaseContagion.hpp>
 #include <DiscreteSIR.hpp>
 #include <ContinuousSIR.hpp>
+#include <ContinuousSEIR.hpp>
+#include <ContinuousSIRS.hpp>
+#include <ContinuousSIS.hpp>
+#include <DiscreteSEIR.hpp>
+#include <NextReactionSIR.hpp>
+#include <WeightedContinuousSIR.hpp>
+#include <DurationDistribution.hpp>
 #include <AnnealedContinuousSIR.hpp>
+#include <sstream>
+#include <type_traits>
 
 using namespace std;
 using namespace fastsir;
 
 namespace py = pybind11;
 
+//pickled state of a process: its binary state with the network
+template <typename Process>
+py::bytes get_pickle_state(const Process& process)
+{
+    ostringstream stream(ios::binary);
+    process.save_state(stream, true, true);
+    return py::bytes(stream.str());
+}
+
+//process built on an empty network with placeholder parameters
+template <typename Process>
+Process make_placeholder_process()
+{
+    if constexpr (is_same_v<Process, WeightedContinuousSIR>)
+    {
+        return Process(EdgeList(), vector<double>(), 1., vector<double>({1.}));
+    }
+    else if constexpr (is_constructible_v<Process, EdgeList, double, vector<double>>)
+    {
+        return Process(EdgeList(), 1., vector<double>({0.}));
+    }
+    else
+    {
+        return Process(EdgeList(), 1., 1., vector<double>({0.}));
+    }
+}
+
+//process from a pickled state; the placeholder parameters are replaced by
+//the saved ones
+template <typename Process>
+Process set_pickle_state(const py::bytes& state)
+{
+    istringstream stream(string(state), ios::binary);
+    Process process = make_placeholder_process<Process>();
+    process.load_state(stream);
+    return process;
+}
+
 
 PYBIND11_MODULE(fastsir, m)
 {
@@ -89,9 +136,21 @@ PYBIND11_MODULE(fastsir, m)
             Reset time and system, with all susceptible nodes.
             )pbdoc")
 
+        .def("get_performance_counters", &BaseContagion::get_performance_counters, R"pbdoc(
+            Returns a dict of the performance counters: number of events of
+            each type, neighbor visits, sampling calls and rejection trials,
+            set_weight calls, and time spent in each phase of evolve. The
+            dict is empty unless the module is compiled with FASTSIR_PROFILE.
+            Sampling counters only count the work done during evolve.
+            )pbdoc")
+
+        .def("reset_performance_counters", &BaseContagion::reset_performance_counters, R"pbdoc(
+            Reset the performance counters to zero.
+            )pbdoc")
+
         .def("seed", &BaseContagion::seed,
                 R"pbdoc(
-            Seed the RNG.
+            Seed the RNG of the process.
 
             Args:
                seed: seed for the RNG.
@@ -102,11 +161,127 @@ PYBIND11_MODULE(fastsir, m)
             Let the system evolve over a period of time.
 
             Args:
-               period: Time period of the evolution.
+               period: Time period of the evolution. If infinite, the
+                       process evolves until no event is left and the
+                       time is that of the last event.
                save_transmission_tree: keep track of transmission
                save_macro_state: keep track of the macro state
             )pbdoc", py::arg("period"), py::arg("save_transmission_tree")=true,
                 py::arg("save_macro_state")=true)
+
+        .def("set_infection_rate", &BaseContagion::set_infection_rate,
+                R"pbdoc(
+            Change the infection rates between calls to evolve. For
+            DiscreteSIR, these are the infection probabilities.
+
+            Args:
+               infection_rate: vector for the infection rate for different
+                               infected degree.
+            )pbdoc", py::arg("infection_rate"))
+
+        .def("set_recovery_rate", &BaseContagion::set_recovery_rate,
+                R"pbdoc(
+            Change the recovery rate between calls to evolve. For
+            DiscreteSIR, this is the recovery probability.
+
+            Args:
+               recovery_rate: Double for the recovery rate.
+            )pbdoc", py::arg("recovery_rate"))
+
+        .def("schedule_rates", &BaseContagion::schedule_rates,
+                R"pbdoc(
+            Schedule a change of the rates at a given time; it is applied
+            by evolve when the process reaches that time. A change the model
+            cannot apply is rejected when scheduled.
+
+            Args:
+               time: Time of the change.
+               infection_rate: New infection rates, empty to keep them.
+               recovery_rate: New recovery rate, nan to keep it.
+            )pbdoc", py::arg("time"), py::arg("infection_rate"),
+                py::arg("recovery_rate")=numeric_limits<double>::quiet_NaN())
+
+        .def("clear_rate_schedule", &BaseContagion::clear_rate_schedule,
+                R"pbdoc(
+            Remove the rate changes that are not yet applied.
+            )pbdoc")
+
+        .def("save_state", py::overload_cast<const string&, bool>(
+                    &BaseContagion::save_state, py::const_),
+                R"pbdoc(
+            Save the state of the process in a binary file, between calls to
+            evolve. The network is not saved. Supported by ContinuousSIR,
+            DiscreteSIR and their SEIR, SIRS, SIS and weighted variants, by
+            NextReactionSIR and by AnnealedContinuousSIR.
+
+            Args:
+               path: Path of the file.
+               save_history: Also save the macro states and transmission tree.
+            )pbdoc", py::arg("path"), py::arg("save_history")=true)
+
+        .def("fork", &BaseContagion::fork,
+                R"pbdoc(
+            Returns a copy of the process at its current state, with its own
+            RNG seeded by seed. The network is shared with the copy.
+
+            Args:
+               seed: Seed for the RNG of the copy.
+               copy_history: Also copy the macro states and transmission tree.
+            )pbdoc", py::arg("seed"), py::arg("copy_history")=false)
+
+        .def("evolve_forks", &BaseContagion::evolve_forks,
+                R"pbdoc(
+            Evolve forks of the process over a period on multiple threads;
+            the process itself is unchanged. Returns the list of macro states
+            of each fork, starting with the current state.
+
+            Args:
+               number_of_forks: Number of continuations.
+               period: Time period of the evolution.
+               seed: Seed for the RNG; each fork uses its own stream.
+               number_of_threads: Number of threads.
+            )pbdoc", py::arg("number_of_forks"), py::arg("period"), py::arg("seed"),
+                py::arg("number_of_threads")=1, py::call_guard<py::gil_scoped_release>())
+
+        .def("load_state", py::overload_cast<const string&>(
+                    &BaseContagion::load_state),
+                R"pbdoc(
+            Load a state saved with save_state. The process must be built on
+            the same network; the parameters and the RNG are restored.
+
+            Args:
+               path: Path of the file.
+            )pbdoc", py::arg("path"))
+        ;
+
+
+    /* ======================
+     * Duration distribution
+     * ======================*/
+
+    py::class_<DurationDistribution>(m, "DurationDistribution")
+
+        .def(py::init<std::string, std::vector<double>>(), R"pbdoc(
+            Distribution of the time spent in a compartment.
+
+            Args:
+               name: "none", "exponential" ([rate]), "gamma" ([shape, scale]),
+                     "lognormal" ([mu, sigma]), "weibull" ([shape, scale])
+                     or "fixed" ([duration]).
+               parameters: List of parameters of the distribution.
+            )pbdoc", py::arg("name"), py::arg("parameters"))
+
+        .def("get_name", &DurationDistribution::get_name, R"pbdoc(
+            Returns the name of the distribution.
+            )pbdoc")
+
+        .def("get_parameters", &DurationDistribution::get_parameters, R"pbdoc(
+            Returns the parameters of the distribution.
+            )pbdoc")
+
+        .def("mean", &DurationDistribution::mean, R"pbdoc(
+            Returns the mean duration.
+            )pbdoc")
         ;
 
 
@@ -116,7 +291,7 @@ PYBIND11_MODULE(fastsir, m)
 
     py::class_<DiscreteSIR, BaseContagion>(m, "DiscreteSIR")
 
-        .def(py::init<EdgeList, double,std::vector<double>>(), R"pbdoc(
+        .def(py::init<EdgeList, double,std::vector<double>, bool>(), R"pbdoc(
             Default constructor of the class DiscreteSIR
 
             Args:
@@ -125,14 +300,45 @@ PYBIND11_MODULE(fastsir, m)
                infection_probability: vector for the infection
                                       probability for different infected
                                       degree.
+               directed: If True, an edge (i,j) only lets i infect j.
             )pbdoc", py::arg("edge_list"),
                 py::arg("recovery_probability"),
-                py::arg("infection_probability"))
+                py::arg("infection_probability"),
+                py::arg("directed")=false)
 
         .def("get_lifetime", &DiscreteSIR::get_lifetime, R"pbdoc(
             Returns the lifetime for the current state.
             )pbdoc")
 
+        .def("set_number_of_threads", &DiscreteSIR::set_number_of_threads, R"pbdoc(
+            Set the number of threads used to perform each time step.
+            Steps with few events are performed on a single thread.
+
+            Args:
+               number_of_threads: Number of threads.
+            )pbdoc", py::arg("number_of_threads"))
+
+        .def("get_number_of_threads", &DiscreteSIR::get_number_of_threads, R"pbdoc(
+            Returns the number of threads used to perform each time step.
+            )pbdoc")
+
+        .def("set_infection_probability", &DiscreteSIR::set_infection_probability,
+                R"pbdoc(
+            Change the infection probabilities between calls to evolve.
+
+            Args:
+               infection_probability: vector for the infection probability
+                                      for different infected degree.
+            )pbdoc", py::arg("infection_probability"))
+
+        .def("set_recovery_probability", &DiscreteSIR::set_recovery_probability,
+                R"pbdoc(
+            Change the recovery probability between calls to evolve.
+
+            Args:
+               recovery_probability: Double for the recovery probability.
+            )pbdoc", py::arg("recovery_probability"))
+
         .def("get_current_macro_state", &DiscreteSIR::get_current_macro_state, R"pbdoc(
             Returns the current macro state
             )pbdoc")
@@ -144,11 +350,14 @@ PYBIND11_MODULE(fastsir, m)
         .def("get_macro_state_vector", &DiscreteSIR::get_macro_state_vector, R"pbdoc(
             Returns the vector of macro states
             )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<DiscreteSIR>,
+                    &set_pickle_state<DiscreteSIR>))
         ;
 
     py::class_<ContinuousSIR, BaseContagion>(m, "ContinuousSIR")
 
-        .def(py::init<EdgeList, double,std::vector<double>>(), R"pbdoc(
+        .def(py::init<EdgeList, double,std::vector<double>, bool>(), R"pbdoc(
             Default constructor of the class ContinuousSIR
 
             Args:
@@ -157,14 +366,32 @@ PYBIND11_MODULE(fastsir, m)
                infection_rate: vector for the infection
                                       rate for different infected
                                       degree.
+               directed: If True, an edge (i,j) only lets i infect j.
             )pbdoc", py::arg("edge_list"),
                 py::arg("recovery_rate"),
-                py::arg("infection_rate"))
+                py::arg("infection_rate"),
+                py::arg("directed")=false)
 
         .def("get_lifetime", &ContinuousSIR::get_lifetime, R"pbdoc(
             Returns the lifetime for the current state.
             )pbdoc")
 
+        .def("set_tau_leaping", &ContinuousSIR::set_tau_leaping, R"pbdoc(
+            Enable approximate tau-leaping steps, with a Poisson number of
+            infections and recoveries per leap.
+
+            Args:
+               error: Bound on the expected relative change of the number
+                      of susceptible and infected nodes during a leap
+                      (typically 0.01-0.05). 0 disables tau-leaping.
+               minimum_infected: Exact steps are performed when fewer
+                                 nodes are infected.
+            )pbdoc", py::arg("error"), py::arg("minimum_infected")=100)
+
+        .def("get_tau_leaping_error", &ContinuousSIR::get_tau_leaping_error, R"pbdoc(
+            Returns the error parameter of tau-leaping (0 if disabled).
+            )pbdoc")
+
         .def("get_current_macro_state", &ContinuousSIR::get_current_macro_state, R"pbdoc(
             Returns the current macro state
             )pbdoc")
@@ -176,13 +403,370 @@ PYBIND11_MODULE(fastsir, m)
         .def("get_macro_state_vector", &ContinuousSIR::get_macro_state_vector, R"pbdoc(
             Returns the vector of macro states
             )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<ContinuousSIR>,
+                    &set_pickle_state<ContinuousSIR>))
+        ;
+
+
+    py::class_<ContinuousSEIR, BaseContagion>(m, "ContinuousSEIR")
+
+        .def(py::init<EdgeList, double, double, std::vector<double>, bool>(), R"pbdoc(
+            Default constructor of the class ContinuousSEIR. Infected nodes
+            are exposed before becoming infectious; they are counted as
+            infected in the macro states.
+
+            Args:
+               edge_list: Edge list for the network structure.
+               onset_rate: Double for the rate at which exposed nodes
+                           become infectious.
+               recovery_rate: Double for the recovery rate
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("onset_rate"),
+                py::arg("recovery_rate"),
+                py::arg("infection_rate"),
+                py::arg("directed")=false)
+
+        .def("get_lifetime", &ContinuousSEIR::get_lifetime, R"pbdoc(
+            Returns the lifetime for the current state.
+            )pbdoc")
+
+        .def("get_number_of_exposed_nodes", &ContinuousSEIR::get_number_of_exposed_nodes, R"pbdoc(
+            Returns the number of exposed nodes.
+            )pbdoc")
+
+        .def("get_current_macro_state", &ContinuousSEIR::get_current_macro_state, R"pbdoc(
+            Returns the current macro state
+            )pbdoc")
+
+        .def("get_transmission_tree", &ContinuousSEIR::get_transmission_tree, R"pbdoc(
+            Returns the transmission tree
+            )pbdoc")
+
+        .def("get_macro_state_vector", &ContinuousSEIR::get_macro_state_vector, R"pbdoc(
+            Returns the vector of macro states
+            )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<ContinuousSEIR>,
+                    &set_pickle_state<ContinuousSEIR>))
+        ;
+
+    py::class_<DiscreteSEIR, BaseContagion>(m, "DiscreteSEIR")
+
+        .def(py::init<EdgeList, double, double, std::vector<double>, bool>(), R"pbdoc(
+            Default constructor of the class DiscreteSEIR. Infected nodes
+            are exposed before becoming infectious; they are counted as
+            infected in the macro states.
+
+            Args:
+               edge_list: Edge list for the network structure.
+               onset_probability: Double for the probability per time step
+                                  that an exposed node becomes infectious.
+               recovery_probability: Double for the recovery probability
+               infection_probability: vector for the infection
+                                      probability for different infected
+                                      degree.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("onset_probability"),
+                py::arg("recovery_probability"),
+                py::arg("infection_probability"),
+                py::arg("directed")=false)
+
+        .def("get_lifetime", &DiscreteSEIR::get_lifetime, R"pbdoc(
+            Returns the lifetime for the current state.
+            )pbdoc")
+
+        .def("get_number_of_exposed_nodes", &DiscreteSEIR::get_number_of_exposed_nodes, R"pbdoc(
+            Returns the number of exposed nodes.
+            )pbdoc")
+
+        .def("set_number_of_threads", &DiscreteSEIR::set_number_of_threads, R"pbdoc(
+            Set the number of threads used to perform each time step.
+            Steps with few events are performed on a single thread.
+
+            Args:
+               number_of_threads: Number of threads.
+            )pbdoc", py::arg("number_of_threads"))
+
+        .def("get_number_of_threads", &DiscreteSEIR::get_number_of_threads, R"pbdoc(
+            Returns the number of threads used to perform each time step.
+            )pbdoc")
+
+        .def("get_current_macro_state", &DiscreteSEIR::get_current_macro_state, R"pbdoc(
+            Returns the current macro state
+            )pbdoc")
+
+        .def("get_transmission_tree", &DiscreteSEIR::get_transmission_tree, R"pbdoc(
+            Returns the transmission tree
+            )pbdoc")
+
+        .def("get_macro_state_vector", &DiscreteSEIR::get_macro_state_vector, R"pbdoc(
+            Returns the vector of macro states
+            )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<DiscreteSEIR>,
+                    &set_pickle_state<DiscreteSEIR>))
+        ;
+
+    py::class_<ContinuousSIRS, BaseContagion>(m, "ContinuousSIRS")
+
+        .def(py::init<EdgeList, double, double, std::vector<double>, bool>(), R"pbdoc(
+            Default constructor of the class ContinuousSIRS. Recovered nodes
+            become susceptible again; the process stops when no node is
+            infected.
+
+            Args:
+               edge_list: Edge list for the network structure.
+               recovery_rate: Double for the recovery rate
+               waning_rate: Double for the rate at which recovered nodes
+                            become susceptible.
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("recovery_rate"),
+                py::arg("waning_rate"),
+                py::arg("infection_rate"),
+                py::arg("directed")=false)
+
+        .def("get_lifetime", &ContinuousSIRS::get_lifetime, R"pbdoc(
+            Returns the lifetime for the current state.
+            )pbdoc")
+
+        .def("get_current_macro_state", &ContinuousSIRS::get_current_macro_state, R"pbdoc(
+            Returns the current macro state
+            )pbdoc")
+
+        .def("get_transmission_tree", &ContinuousSIRS::get_transmission_tree, R"pbdoc(
+            Returns the transmission tree
+            )pbdoc")
+
+        .def("get_macro_state_vector", &ContinuousSIRS::get_macro_state_vector, R"pbdoc(
+            Returns the vector of macro states
+            )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<ContinuousSIRS>,
+                    &set_pickle_state<ContinuousSIRS>))
+        ;
+
+    py::class_<ContinuousSIS, BaseContagion>(m, "ContinuousSIS")
+
+        .def(py::init<EdgeList, double, std::vector<double>, bool>(), R"pbdoc(
+            Default constructor of the class ContinuousSIS. Recovered nodes
+            are susceptible again.
+
+            Args:
+               edge_list: Edge list for the network structure.
+               recovery_rate: Double for the recovery rate
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("recovery_rate"),
+                py::arg("infection_rate"),
+                py::arg("directed")=false)
+
+        .def("get_lifetime", &ContinuousSIS::get_lifetime, R"pbdoc(
+            Returns the lifetime for the current state.
+            )pbdoc")
+
+        .def("set_quasistationary", &ContinuousSIS::set_quasistationary, R"pbdoc(
+            Enable the quasi-stationary method: when no node is infected, the
+            process is restored to a random configuration of a reservoir of
+            past configurations, so it never stops and evolve requires a
+            finite period. The quasi-stationary distribution is measured
+            from now on.
+
+            Args:
+               reservoir_size: Number of configurations kept (0 disables).
+               snapshot_period: Time between two configurations stored; once
+                                the reservoir is full, a random one is
+                                replaced.
+            )pbdoc", py::arg("reservoir_size"), py::arg("snapshot_period")=1.)
+
+        .def("get_reservoir_size", &ContinuousSIS::get_reservoir_size, R"pbdoc(
+            Returns the size of the reservoir (0 if disabled).
+            )pbdoc")
+
+        .def("get_quasistationary_distribution",
+                &ContinuousSIS::get_quasistationary_distribution, R"pbdoc(
+            Returns the fraction of time spent with each number of infected
+            nodes since the quasi-stationary method was enabled.
+            )pbdoc")
+
+        .def("set_tau_leaping", &ContinuousSIS::set_tau_leaping, R"pbdoc(
+            Enable approximate tau-leaping steps, with a Poisson number of
+            infections and recoveries per leap.
+
+            Args:
+               error: Bound on the expected relative change of the number
+                      of susceptible and infected nodes during a leap
+                      (typically 0.01-0.05). 0 disables tau-leaping.
+               minimum_infected: Exact steps are performed when fewer
+                                 nodes are infected.
+            )pbdoc", py::arg("error"), py::arg("minimum_infected")=100)
+
+        .def("get_current_macro_state", &ContinuousSIS::get_current_macro_state, R"pbdoc(
+            Returns the current macro state
+            )pbdoc")
+
+        .def("get_transmission_tree", &ContinuousSIS::get_transmission_tree, R"pbdoc(
+            Returns the transmission tree
+            )pbdoc")
+
+        .def("get_macro_state_vector", &ContinuousSIS::get_macro_state_vector, R"pbdoc(
+            Returns the vector of macro states
+            )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<ContinuousSIS>,
+                    &set_pickle_state<ContinuousSIS>))
+        ;
+
+
+    py::class_<WeightedContinuousSIR, BaseContagion>(m, "WeightedContinuousSIR")
+
+        .def(py::init<EdgeList, std::vector<double>, double, std::vector<double>,
+                double, bool>(), R"pbdoc(
+            Default constructor of the class WeightedContinuousSIR. The
+            infection rate of a susceptible node depends on the summed weight
+            of the edges to its infected neighbors.
+
+            Args:
+               edge_list: Edge list for the network structure.
+               edge_weight: Non-negative weight of each edge of edge_list.
+               recovery_rate: Double for the recovery rate
+               infection_rate: vector for the infection rate at the infected
+                               weights 0, weight_step, 2*weight_step, ...;
+                               it is interpolated linearly in between and
+                               extrapolated from the last two values beyond.
+               weight_step: Weight between two values of infection_rate.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("edge_weight"),
+                py::arg("recovery_rate"),
+                py::arg("infection_rate"),
+                py::arg("weight_step")=1.,
+                py::arg("directed")=false)
+
+        .def("get_lifetime", &WeightedContinuousSIR::get_lifetime, R"pbdoc(
+            Returns the lifetime for the current state.
+            )pbdoc")
+
+        .def("get_infected_weight", &WeightedContinuousSIR::get_infected_weight, R"pbdoc(
+            Returns the summed weight of the edges to the infected neighbors
+            of a susceptible node.
+
+            Args:
+               node: Label of the node.
+            )pbdoc", py::arg("node"))
+
+        .def("get_weight_step", &WeightedContinuousSIR::get_weight_step, R"pbdoc(
+            Returns the weight between two values of the infection rate.
+            )pbdoc")
+
+        .def("set_tau_leaping", &WeightedContinuousSIR::set_tau_leaping, R"pbdoc(
+            Enable approximate tau-leaping steps, with a Poisson number of
+            infections and recoveries per leap.
+
+            Args:
+               error: Bound on the expected relative change of the number
+                      of susceptible and infected nodes during a leap
+                      (typically 0.01-0.05). 0 disables tau-leaping.
+               minimum_infected: Exact steps are performed when fewer
+                                 nodes are infected.
+            )pbdoc", py::arg("error"), py::arg("minimum_infected")=100)
+
+        .def("get_current_macro_state", &WeightedContinuousSIR::get_current_macro_state, R"pbdoc(
+            Returns the current macro state
+            )pbdoc")
+
+        .def("get_transmission_tree", &WeightedContinuousSIR::get_transmission_tree, R"pbdoc(
+            Returns the transmission tree; the infector is drawn in proportion
+            to the weight of its edge to the infectee.
+            )pbdoc")
+
+        .def("get_macro_state_vector", &WeightedContinuousSIR::get_macro_state_vector, R"pbdoc(
+            Returns the vector of macro states
+            )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<WeightedContinuousSIR>,
+                    &set_pickle_state<WeightedContinuousSIR>))
+        ;
+
+
+    py::class_<NextReactionSIR, BaseContagion>(m, "NextReactionSIR")
+
+        .def(py::init<EdgeList, double,std::vector<double>, bool>(), R"pbdoc(
+            Default constructor of the class NextReactionSIR
+
+            Args:
+               edge_list: Edge list for the network structure.
+               recovery_rate: Double for the recovery rate
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("recovery_rate"),
+                py::arg("infection_rate"),
+                py::arg("directed")=false)
+
+        .def(py::init<EdgeList, std::vector<double>, DurationDistribution,
+                DurationDistribution, bool>(), R"pbdoc(
+            Constructor of the class NextReactionSIR with non-exponential
+            infectious period and latency.
+
+            Args:
+               edge_list: Edge list for the network structure.
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+               infectious_period: DurationDistribution of the time
+                                  spent infectious.
+               latent_period: DurationDistribution of the time between
+                              infection and the onset of infectiousness.
+                              Latent nodes are counted as infected.
+               directed: If True, an edge (i,j) only lets i infect j.
+            )pbdoc", py::arg("edge_list"),
+                py::arg("infection_rate"),
+                py::arg("infectious_period"),
+                py::arg("latent_period")=DurationDistribution(),
+                py::arg("directed")=false)
+
+        .def("get_lifetime", &NextReactionSIR::get_lifetime, R"pbdoc(
+            Returns the time until the next event.
+            )pbdoc")
+
+        .def("get_current_macro_state", &NextReactionSIR::get_current_macro_state, R"pbdoc(
+            Returns the current macro state
+            )pbdoc")
+
+        .def("get_transmission_tree", &NextReactionSIR::get_transmission_tree, R"pbdoc(
+            Returns the transmission tree
+            )pbdoc")
+
+        .def("get_macro_state_vector", &NextReactionSIR::get_macro_state_vector, R"pbdoc(
+            Returns the vector of macro states
+            )pbdoc")
+
+        .def(py::pickle(&get_pickle_state<NextReactionSIR>,
+                    &set_pickle_state<NextReactionSIR>))
         ;
 
 
     py::class_<AnnealedContinuousSIR, BaseContagion>(m, "AnnealedContinuousSIR")
 
-        .def(py::init<int, int, double, std::vector<double>>(), R"pbdoc(
-            Default constructor of the class AnnealedContinuousSIR
+        .def(py::init<std::size_t, int, double, std::vector<double>>(), R"pbdoc(
+            Default constructor of the class AnnealedContinuousSIR. Only
+            the number of nodes in each state is stored; nodes are labeled
+            in order of infection in the transmission tree.
 
             Args:
                number_of_nodes: Number of nodes
@@ -196,6 +780,40 @@ PYBIND11_MODULE(fastsir, m)
                 py::arg("recovery_rate"),
                 py::arg("infection_rate"))
 
+        .def(py::init<std::vector<int>, double, std::vector<double>>(), R"pbdoc(
+            Constructor of the class AnnealedContinuousSIR for heterogeneous
+            degrees. Nodes of the same degree form a class; the infected
+            degree of a node is binomial with the probability that an edge
+            leads to an infected node.
+
+            Args:
+               degree_sequence: List of the degree of each node
+               recovery_rate: Double for the recovery rate
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+            )pbdoc", py::arg("degree_sequence"),
+                py::arg("recovery_rate"),
+                py::arg("infection_rate"))
+
+        .def(py::init<DegreeDistribution, double, std::vector<double>>(), R"pbdoc(
+            Constructor of the class AnnealedContinuousSIR for heterogeneous
+            degrees.
+
+            Args:
+               degree_distribution: Dict of the number of nodes of each degree
+               recovery_rate: Double for the recovery rate
+               infection_rate: vector for the infection
+                                      rate for different infected
+                                      degree.
+            )pbdoc", py::arg("degree_distribution"),
+                py::arg("recovery_rate"),
+                py::arg("infection_rate"))
+
+        .def("get_degree_class_state", &AnnealedContinuousSIR::get_degree_class_state, R"pbdoc(
+            Returns a list of tuples (degree, S, I, R) for each degree class.
+            )pbdoc")
+
         .def("get_lifetime", &AnnealedContinuousSIR::get_lifetime, R"pbdoc(
             Returns the lifetime for the current state.
             )pbdoc")
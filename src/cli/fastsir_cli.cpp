@@ -0,0 +1,439 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//command line interface to run ensembles of simulations without python
+//
+//usage: fastsir_cli <edge_list_file> <parameter_file>
+//
+//the edge list file contains one edge "node node" per line, with an optional
+//weight "node node weight" (default 1), and the parameter file one
+//"key = value" per line; lines starting with '#' are ignored.
+//
+//  model              discrete, continuous, next_reaction, discrete_seir,
+//                     continuous_seir, continuous_sirs, continuous_sis or
+//                     weighted_continuous (default continuous)
+//  recovery_rate      recovery rate (probability for the discrete models)
+//  onset_rate         rate at which exposed nodes become infectious for the
+//                     SEIR models (probability for the discrete model)
+//  waning_rate        rate at which recovered nodes become susceptible for
+//                     the SIRS model
+//  reservoir_size     number of configurations of the quasi-stationary
+//                     method for the SIS model (default 0: disabled); the
+//                     period must then be given
+//  snapshot_period    time between configurations stored (default 1)
+//  directed           1 if an edge "i j" only lets i infect j (default 0)
+//  infection_rate     comma-separated rates for each infected degree, or
+//                     for each multiple of weight_step of the infected
+//                     weight with the weighted model
+//  transmission_rate  rate per infected neighbor (probability for discrete),
+//                     or per unit of infected weight
+//  weight_step        weight between the infection rates of the weighted
+//                     model (default 1)
+//  initial_fraction   fraction of nodes infected initially, or
+//  initial_infected   number of nodes infected initially (default 1)
+//  period             duration of each simulation (default: until extinction)
+//  number_of_samples  number of simulations (default 1)
+//  seed               seed of the RNG (default: time based)
+//  macro_state        1 to output every macro state, 0 for the final one only
+//  tau_leaping_error  tau-leaping error for the continuous, SIS and weighted
+//                     models
+//  number_of_threads  number of threads for the discrete models
+//  output             path of the CSV output (default: standard output)
+//
+//the output is a CSV file with columns sample,time,S,I,R
+
+#include "ContinuousSIR.hpp"
+#include "ContinuousSEIR.hpp"
+#include "ContinuousSIRS.hpp"
+#include "ContinuousSIS.hpp"
+#include "DiscreteSIR.hpp"
+#include "DiscreteSEIR.hpp"
+#include "NextReactionSIR.hpp"
+#include "WeightedContinuousSIR.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+using namespace fastsir;
+
+typedef map<string,string> ParameterMap;
+
+
+//remove the leading and trailing whitespaces
+static string strip(const string& str)
+{
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == string::npos)
+    {
+        return string();
+    }
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, last - first + 1);
+}
+
+//read an edge list, one edge per line, and the edge weights
+static EdgeList read_edge_list(const string& path, vector<double>& edge_weight)
+{
+    ifstream file(path);
+    if (not file)
+    {
+        throw runtime_error("Cannot open the edge list file " + path);
+    }
+    EdgeList edge_list;
+    string line;
+    size_t line_number = 0;
+    const long long max_node = numeric_limits<Node>::max();
+    while (getline(file, line))
+    {
+        line_number += 1;
+        line = strip(line);
+        if (line.empty() or line[0] == '#')
+        {
+            continue;
+        }
+        istringstream stream(line);
+        long long first, second;
+        double weight = 1.;
+        if (not (stream >> first >> second) or first < 0 or second < 0
+                or first > max_node or second > max_node
+                or (not (stream >> ws).eof() and not (stream >> weight)))
+        {
+            throw runtime_error("Invalid edge at line " + to_string(line_number)
+                    + " of " + path);
+        }
+        edge_list.emplace_back(first, second);
+        edge_weight.push_back(weight);
+    }
+    if (edge_list.empty())
+    {
+        throw runtime_error("The edge list " + path + " is empty");
+    }
+    return edge_list;
+}
+
+//read the parameters, one "key = value" per line
+static ParameterMap read_parameters(const string& path)
+{
+    ifstream file(path);
+    if (not file)
+    {
+        throw runtime_error("Cannot open the parameter file " + path);
+    }
+    ParameterMap parameter_map;
+    string line;
+    size_t line_number = 0;
+    while (getline(file, line))
+    {
+        line_number += 1;
+        line = strip(line);
+        if (line.empty() or line[0] == '#')
+        {
+            continue;
+        }
+        size_t separator = line.find('=');
+        if (separator == string::npos)
+        {
+            throw runtime_error("Expected key = value at line "
+                    + to_string(line_number) + " of " + path);
+        }
+        parameter_map[strip(line.substr(0, separator))] = strip(line.substr(separator + 1));
+    }
+    return parameter_map;
+}
+
+//get a parameter, or a default value if absent
+static string get_parameter(const ParameterMap& parameter_map, const string& key,
+        const string& default_value)
+{
+    auto it = parameter_map.find(key);
+    return it == parameter_map.end() ? default_value : it->second;
+}
+
+static double to_double(const string& key, const string& value)
+{
+    try
+    {
+        size_t position;
+        double result = stod(value, &position);
+        if (position == value.size())
+        {
+            return result;
+        }
+    }
+    catch (const logic_error&) {}
+    throw invalid_argument("Invalid value for " + key + ": " + value);
+}
+
+//discrete models take probabilities instead of rates
+static bool is_discrete(const string& model)
+{
+    return model == "discrete" or model == "discrete_seir";
+}
+
+//get the infection rate for each infected degree
+//(the number of infected in-neighbors for a directed network)
+static vector<double> get_infection_rate(const ParameterMap& parameter_map,
+        const string& model, size_t max_degree)
+{
+    vector<double> infection_rate;
+    if (parameter_map.count("infection_rate"))
+    {
+        istringstream stream(parameter_map.at("infection_rate"));
+        string value;
+        while (getline(stream, value, ','))
+        {
+            infection_rate.push_back(to_double("infection_rate", strip(value)));
+        }
+        if (model != "weighted_continuous" and infection_rate.size() <= max_degree)
+        {
+            throw invalid_argument("infection_rate must be given up to the maximal degree "
+                    + to_string(max_degree));
+        }
+    }
+    else if (parameter_map.count("transmission_rate"))
+    {
+        double transmission_rate = to_double("transmission_rate",
+                parameter_map.at("transmission_rate"));
+        if (model == "weighted_continuous")
+        {
+            //linear in the infected weight
+            double weight_step = to_double("weight_step",
+                    get_parameter(parameter_map, "weight_step", "1"));
+            return vector<double>({0., transmission_rate*weight_step});
+        }
+        for (size_t k = 0; k <= max_degree; k++)
+        {
+            infection_rate.push_back(is_discrete(model) ?
+                    1 - pow(1 - transmission_rate, k) : transmission_rate*k);
+        }
+    }
+    else
+    {
+        throw invalid_argument("infection_rate or transmission_rate must be given");
+    }
+    return infection_rate;
+}
+
+//create the process from the model name
+static unique_ptr<BaseContagion> make_process(const ParameterMap& parameter_map,
+        const EdgeList& edge_list, const vector<double>& edge_weight)
+{
+    string model = get_parameter(parameter_map, "model", "continuous");
+    double recovery_rate = to_double("recovery_rate",
+            get_parameter(parameter_map, "recovery_rate", "1"));
+    bool directed = to_double("directed",
+            get_parameter(parameter_map, "directed", "0"));
+    //the network is built once, with the weights only for the weighted model
+    shared_ptr<const Network> network = model == "weighted_continuous" ?
+        make_shared<const Network>(edge_list, edge_weight, directed) :
+        make_shared<const Network>(edge_list, directed);
+    vector<double> infection_rate = get_infection_rate(parameter_map, model,
+            network->max_in_degree());
+
+    if (model == "continuous" or model == "continuous_sis"
+            or model == "weighted_continuous")
+    {
+        unique_ptr<ContinuousSIR> process;
+        if (model == "continuous")
+        {
+            process.reset(new ContinuousSIR(network, recovery_rate, infection_rate));
+        }
+        else if (model == "weighted_continuous")
+        {
+            process.reset(new WeightedContinuousSIR(network, recovery_rate,
+                        infection_rate, to_double("weight_step",
+                            get_parameter(parameter_map, "weight_step", "1"))));
+        }
+        else
+        {
+            unique_ptr<ContinuousSIS> sis_process(new ContinuousSIS(network,
+                        recovery_rate, infection_rate));
+            size_t reservoir_size = to_double("reservoir_size",
+                    get_parameter(parameter_map, "reservoir_size", "0"));
+            //the quasi-stationary method never reaches extinction
+            if (reservoir_size > 0 and not parameter_map.count("period"))
+            {
+                throw invalid_argument("period must be given with reservoir_size");
+            }
+            sis_process->set_quasistationary(reservoir_size,
+                    to_double("snapshot_period",
+                        get_parameter(parameter_map, "snapshot_period", "1")));
+            process = move(sis_process);
+        }
+        if (parameter_map.count("tau_leaping_error"))
+        {
+            process->set_tau_leaping(to_double("tau_leaping_error",
+                        parameter_map.at("tau_leaping_error")));
+        }
+        return process;
+    }
+    if (is_discrete(model))
+    {
+        unique_ptr<DiscreteSIR> process;
+        if (model == "discrete")
+        {
+            process.reset(new DiscreteSIR(network, recovery_rate, infection_rate));
+        }
+        else
+        {
+            process.reset(new DiscreteSEIR(network, to_double("onset_rate",
+                            get_parameter(parameter_map, "onset_rate", "1")),
+                        recovery_rate, infection_rate));
+        }
+        if (parameter_map.count("number_of_threads"))
+        {
+            process->set_number_of_threads(to_double("number_of_threads",
+                        parameter_map.at("number_of_threads")));
+        }
+        return process;
+    }
+    if (model == "next_reaction")
+    {
+        return unique_ptr<BaseContagion>(new NextReactionSIR(network,
+                    recovery_rate, infection_rate));
+    }
+    if (model == "continuous_seir")
+    {
+        return unique_ptr<BaseContagion>(new ContinuousSEIR(network,
+                    to_double("onset_rate", get_parameter(parameter_map, "onset_rate", "1")),
+                    recovery_rate, infection_rate));
+    }
+    if (model == "continuous_sirs")
+    {
+        return unique_ptr<BaseContagion>(new ContinuousSIRS(network, recovery_rate,
+                    to_double("waning_rate", get_parameter(parameter_map, "waning_rate", "1")),
+                    infection_rate));
+    }
+    throw invalid_argument("Unknown model " + model);
+}
+
+//infect the initial nodes, chosen at random
+static void infect_initial_nodes(BaseContagion& process, const ParameterMap& parameter_map,
+        sset::RNGType& gen)
+{
+    if (parameter_map.count("initial_fraction"))
+    {
+        process.infect_fraction(to_double("initial_fraction",
+                    parameter_map.at("initial_fraction")));
+        return;
+    }
+    size_t initial_infected = to_double("initial_infected",
+            get_parameter(parameter_map, "initial_infected", "1"));
+    if (initial_infected > process.size())
+    {
+        throw invalid_argument("initial_infected is larger than the number of nodes");
+    }
+    uniform_int_distribution<Node> random_node(0, process.size() - 1);
+    unordered_set<Node> node_set;
+    while (node_set.size() < initial_infected)
+    {
+        node_set.insert(random_node(gen));
+    }
+    process.infect_node_set(node_set);
+}
+
+//run the ensemble of simulations and write the macro states
+static void run(const EdgeList& edge_list, const vector<double>& edge_weight,
+        const ParameterMap& parameter_map, ostream& output)
+{
+    unique_ptr<BaseContagion> process = make_process(parameter_map, edge_list,
+            edge_weight);
+    if (parameter_map.count("seed"))
+    {
+        //the process has its own RNG; the shared one draws the initial nodes
+        unsigned int seed = to_double("seed", parameter_map.at("seed"));
+        process->seed(seed);
+        sset::BaseSamplableSet::seed(seed);
+    }
+    double period = to_double("period", get_parameter(parameter_map, "period",
+                "inf"));
+    size_t number_of_samples = to_double("number_of_samples",
+            get_parameter(parameter_map, "number_of_samples", "1"));
+    bool save_macro_state = to_double("macro_state",
+            get_parameter(parameter_map, "macro_state", "0"));
+
+    output.precision(numeric_limits<double>::max_digits10);
+    output << "sample,time,S,I,R\n";
+    for (size_t sample = 0; sample < number_of_samples; sample++)
+    {
+        process->reset();
+        infect_initial_nodes(*process, parameter_map, sset::BaseSamplableSet::gen_);
+        process->evolve(period, false, save_macro_state);
+
+        vector<MacroState> macro_state_vector = save_macro_state ?
+            process->get_macro_state_vector() :
+            vector<MacroState>({process->get_current_macro_state()});
+        for (const MacroState& macro_state : macro_state_vector)
+        {
+            output << sample << ","
+                   << get<0>(macro_state) << ","
+                   << get<1>(macro_state) << ","
+                   << get<2>(macro_state) << ","
+                   << get<3>(macro_state) << "\n";
+        }
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        cerr << "usage: " << argv[0] << " <edge_list_file> <parameter_file>" << endl;
+        return 2;
+    }
+    try
+    {
+        vector<double> edge_weight;
+        EdgeList edge_list = read_edge_list(argv[1], edge_weight);
+        ParameterMap parameter_map = read_parameters(argv[2]);
+        string output_path = get_parameter(parameter_map, "output", "");
+        if (output_path.empty())
+        {
+            run(edge_list, edge_weight, parameter_map, cout);
+        }
+        else
+        {
+            ofstream output(output_path);
+            if (not output)
+            {
+                throw runtime_error("Cannot open the output file " + output_path);
+            }
+            run(edge_list, edge_weight, parameter_map, output);
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << "fastsir_cli: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
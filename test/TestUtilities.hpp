@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TESTUTILITIES_HPP_
+#define TESTUTILITIES_HPP_
+
+#include "BaseContagion.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fastsir
+{//start of namespace fastsir
+
+//utilities shared by the C++ tests
+
+inline int number_of_failures = 0;
+
+//count a failure if the condition is false
+inline void check(bool condition, const std::string& message)
+{
+    if (not condition)
+    {
+        std::cerr << "FAILED: " << message << std::endl;
+        number_of_failures += 1;
+    }
+}
+
+//whether the function throws the exception
+template<class Exception, class Func>
+bool throws(Func func)
+{
+    try
+    {
+        func();
+    }
+    catch (const Exception&)
+    {
+        return true;
+    }
+    return false;
+}
+
+//ring lattice with random shortcuts, without duplicate edges
+inline EdgeList make_edge_list(Node number_of_nodes, std::size_t number_of_shortcuts,
+        unsigned int seed)
+{
+    std::set<std::pair<Node,Node>> edge_set;
+    for (Node node = 0; node < number_of_nodes; node++)
+    {
+        for (Node step = 1; step <= 2; step++)
+        {
+            Node neighbor = (node + step) % number_of_nodes;
+            edge_set.emplace(std::min(node, neighbor), std::max(node, neighbor));
+        }
+    }
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<Node> random_node(0, number_of_nodes - 1);
+    while (edge_set.size() < 2*number_of_nodes + number_of_shortcuts)
+    {
+        Node first = random_node(gen);
+        Node second = random_node(gen);
+        if (first != second)
+        {
+            edge_set.emplace(std::min(first, second), std::max(first, second));
+        }
+    }
+    return EdgeList(edge_set.begin(), edge_set.end());
+}
+
+//rates proportional to the infected degree, up to the maximal degree
+inline std::vector<double> make_infection_rate(const EdgeList& edge_list, double rate)
+{
+    std::vector<double> infection_rate;
+    for (std::size_t k = 0; k <= Network(edge_list).max_in_degree(); k++)
+    {
+        infection_rate.push_back(rate*k);
+    }
+    return infection_rate;
+}
+
+//report the failures; returns the exit status of the test
+inline int report()
+{
+    if (number_of_failures > 0)
+    {
+        std::cerr << number_of_failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
+
+}//end of namespace fastsir
+
+#endif /* TESTUTILITIES_HPP_ */
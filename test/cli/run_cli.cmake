@@ -0,0 +1,57 @@
+#run fastsir_cli twice on the same files; both runs must succeed and give the
+#same output, since the parameter files fix the seed, and every row must be a
+#valid macro state of the network
+#
+#usage: cmake -DCLI=<fastsir_cli> -DEDGE_LIST=<file> -DPARAMETERS=<file>
+#             [-DDELAY=<seconds>] -P run_cli.cmake
+#
+#DELAY waits between the runs, so that an RNG seeded from the clock would
+#differ
+
+foreach(run 1 2)
+    if(run EQUAL 2 AND DELAY)
+        execute_process(COMMAND ${CMAKE_COMMAND} -E sleep ${DELAY})
+    endif()
+    execute_process(COMMAND ${CLI} ${EDGE_LIST} ${PARAMETERS}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output_${run}
+        ERROR_VARIABLE error)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "fastsir_cli failed (${result}): ${error}")
+    endif()
+endforeach()
+
+if(NOT output_1 MATCHES "^sample,time,S,I,R\n0,")
+    message(FATAL_ERROR "Unexpected output:\n${output_1}")
+endif()
+#the number of nodes is one more than the largest node of the edge list
+file(STRINGS ${EDGE_LIST} edge_lines REGEX "^[ \t]*[0-9]")
+set(number_of_nodes 0)
+foreach(line IN LISTS edge_lines)
+    string(REGEX MATCHALL "[0-9]+" nodes "${line}")
+    list(GET nodes 0 first)
+    list(GET nodes 1 second)
+    foreach(node ${first} ${second})
+        if(node GREATER_EQUAL number_of_nodes)
+            math(EXPR number_of_nodes "${node} + 1")
+        endif()
+    endforeach()
+endforeach()
+
+#each row must have a finite time, even when evolving until extinction,
+#and every node must be in one of S, I or R
+string(REGEX REPLACE "\n$" "" rows "${output_1}")
+string(REPLACE "\n" ";" rows "${rows}")
+list(REMOVE_AT rows 0)
+foreach(row IN LISTS rows)
+    if(NOT row MATCHES "^[0-9]+,[-+.e0-9]+,([0-9]+),([0-9]+),([0-9]+)$")
+        message(FATAL_ERROR "Invalid row in the output: ${row}")
+    endif()
+    math(EXPR total "${CMAKE_MATCH_1} + ${CMAKE_MATCH_2} + ${CMAKE_MATCH_3}")
+    if(NOT total EQUAL number_of_nodes)
+        message(FATAL_ERROR "S+I+R is ${total} instead of ${number_of_nodes}: ${row}")
+    endif()
+endforeach()
+if(NOT output_1 STREQUAL output_2)
+    message(FATAL_ERROR "The output differs between two runs with the same seed")
+endif()
@@ -0,0 +1,292 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//tests of the continuation of processes: snapshots, forks and scheduled
+//changes of rates must give the same trajectory as an uninterrupted process
+//
+//usage: test_continuation (returns 1 if a check fails)
+
+#include "AnnealedContinuousSIR.hpp"
+#include "ContinuousSIR.hpp"
+#include "ContinuousSIS.hpp"
+#include "DiscreteSIR.hpp"
+#include "NextReactionSIR.hpp"
+#include "TestUtilities.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+using namespace fastsir;
+
+//evolve a copy of the process in one go, and another in two parts with a
+//snapshot in between; the snapshot is loaded into the process given
+template<class Process>
+static void check_snapshot(const string& name, const Process& initial_process,
+        Process& loaded_process, double first_period, double second_period,
+        bool save_network)
+{
+    Process process(initial_process);
+    process.evolve(first_period + second_period, true, true);
+
+    Process interrupted_process(initial_process);
+    interrupted_process.evolve(first_period, true, true);
+    stringstream stream;
+    interrupted_process.save_state(stream, true, save_network);
+    loaded_process.load_state(stream);
+    loaded_process.evolve(second_period, true, true);
+
+    check(get<0>(loaded_process.get_macro_state_vector().back()) > first_period,
+            name + ": no event after the snapshot");
+    check(loaded_process.get_macro_state_vector() == process.get_macro_state_vector(),
+            name + ": macro states differ after the snapshot");
+    check(loaded_process.get_transmission_tree() == process.get_transmission_tree(),
+            name + ": transmission trees differ after the snapshot");
+    check(loaded_process.get_current_macro_state() == process.get_current_macro_state(),
+            name + ": current macro states differ after the snapshot");
+}
+
+static void test_continuous_snapshot(const EdgeList& edge_list)
+{
+    vector<double> infection_rate = make_infection_rate(edge_list, 1.);
+    ContinuousSIR process(edge_list, 1., infection_rate);
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    ContinuousSIR loaded_process(edge_list, 1., infection_rate);
+    check_snapshot("ContinuousSIR", process, loaded_process, 2., 1000., false);
+
+    //the rates scheduled after the snapshot are part of it
+    process.schedule_rates(3., make_infection_rate(edge_list, 0.5), 2.);
+    ContinuousSIR scheduled_process(edge_list, 1., infection_rate);
+    check_snapshot("ContinuousSIR with scheduled rates", process, scheduled_process,
+            2., 1000., false);
+
+    //with the network, a snapshot is loaded into a process on an empty
+    //network, as done when unpickling
+    ContinuousSIR placeholder_process(EdgeList(), 1., vector<double>({0.}));
+    check_snapshot("ContinuousSIR with network", process, placeholder_process,
+            2., 1000., true);
+}
+
+static void test_discrete_snapshot(const EdgeList& edge_list)
+{
+    vector<double> infection_probability;
+    for (size_t k = 0; k <= Network(edge_list).max_in_degree(); k++)
+    {
+        infection_probability.push_back(1 - pow(1 - 0.4, k));
+    }
+    DiscreteSIR process(edge_list, 0.3, infection_probability);
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    DiscreteSIR loaded_process(edge_list, 0.3, infection_probability);
+    check_snapshot("DiscreteSIR", process, loaded_process, 3., 1000., false);
+
+    DiscreteSIR placeholder_process(EdgeList(), 1., vector<double>({0.}));
+    check_snapshot("DiscreteSIR with network", process, placeholder_process,
+            3., 1000., true);
+}
+
+//the forks do not depend on the number of threads, and leave the process
+//unchanged
+//the duration distributions are part of the snapshot, with the value the
+//normal distributions keep for the next draw
+static void test_next_reaction_snapshot(const EdgeList& edge_list)
+{
+    vector<double> infection_rate = make_infection_rate(edge_list, 1.);
+    NextReactionSIR process(edge_list, infection_rate, DurationDistribution("gamma", {2., 0.5}),
+            DurationDistribution("lognormal", {-1., 0.5}));
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    NextReactionSIR loaded_process(edge_list, 1., infection_rate);
+    check_snapshot("NextReactionSIR", process, loaded_process, 2., 1000., false);
+
+    NextReactionSIR placeholder_process(EdgeList(), 1., vector<double>({0.}));
+    check_snapshot("NextReactionSIR with network", process, placeholder_process,
+            2., 1000., true);
+}
+
+static void test_annealed_snapshot()
+{
+    DegreeDistribution degree_distribution({{3, 2000}, {10, 500}});
+    vector<double> infection_rate;
+    for (int k = 0; k <= 10; k++)
+    {
+        infection_rate.push_back(0.5*k);
+    }
+    AnnealedContinuousSIR process(degree_distribution, 1., infection_rate);
+    process.seed(42);
+    process.infect_fraction(0.01);
+    AnnealedContinuousSIR loaded_process(degree_distribution, 2., vector<double>(11, 0.));
+    check_snapshot("AnnealedContinuousSIR", process, loaded_process, 1., 1000., false);
+
+    AnnealedContinuousSIR other_process(2500, 3, 1., infection_rate);
+    stringstream stream;
+    process.save_state(stream);
+    check(throws<runtime_error>([&]() {other_process.load_state(stream);}),
+            "AnnealedContinuousSIR: snapshot loaded with other degree classes");
+}
+
+static void test_forks(const EdgeList& edge_list)
+{
+    ContinuousSIR process(edge_list, 1., make_infection_rate(edge_list, 1.));
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    process.evolve(1., false, true);
+    vector<MacroState> macro_state_vector = process.get_macro_state_vector();
+
+    vector<vector<MacroState>> sequential_forks = process.evolve_forks(8, 1000., 7, 1);
+    vector<vector<MacroState>> parallel_forks = process.evolve_forks(8, 1000., 7, 4);
+    check(sequential_forks.size() == 8, "evolve_forks: wrong number of forks");
+    check(sequential_forks == parallel_forks,
+            "evolve_forks: results differ between 1 and 4 threads");
+    check(sequential_forks[0] != sequential_forks[1],
+            "evolve_forks: the forks are not independent");
+    check(process.get_macro_state_vector() == macro_state_vector,
+            "evolve_forks: the process was changed");
+}
+
+//a change of rates the model cannot apply is rejected when scheduled
+static void test_schedule(const EdgeList& edge_list)
+{
+    NextReactionSIR process(edge_list, 1., make_infection_rate(edge_list, 1.));
+    check(throws<runtime_error>([&]() {process.schedule_rates(1., vector<double>(), 2.);}),
+            "schedule_rates: unsupported recovery rate accepted");
+
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    process.schedule_rates(1., make_infection_rate(edge_list, 0.5));
+    process.evolve(1000., false, false);
+    check(process.get_number_of_infected_nodes() == 0,
+            "schedule_rates: the process did not reach extinction");
+}
+
+//infection rates that do not cover the maximal degree, or that are negative,
+//are rejected when scheduled and leave the process unchanged
+static void test_invalid_rates(const EdgeList& edge_list)
+{
+    ContinuousSIR process(edge_list, 1., make_infection_rate(edge_list, 1.));
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    ContinuousSIR reference_process(process);
+
+    vector<double> short_infection_rate = make_infection_rate(edge_list, 1.);
+    short_infection_rate.pop_back();
+    check(throws<invalid_argument>([&]() {process.schedule_rates(0.5, short_infection_rate);}),
+            "schedule_rates: infection rates shorter than the maximal degree accepted");
+    check(throws<invalid_argument>([&]() {process.set_infection_rate(short_infection_rate);}),
+            "set_infection_rate: infection rates shorter than the maximal degree accepted");
+    vector<double> negative_infection_rate = make_infection_rate(edge_list, 1.);
+    negative_infection_rate.back() = -1.;
+    check(throws<invalid_argument>([&]() {process.schedule_rates(0.5, negative_infection_rate);}),
+            "schedule_rates: negative infection rate accepted");
+
+    NextReactionSIR next_reaction_process(edge_list, 1., make_infection_rate(edge_list, 1.));
+    check(throws<invalid_argument>([&]()
+                {next_reaction_process.schedule_rates(0.5, short_infection_rate);}),
+            "NextReactionSIR: infection rates shorter than the maximal degree accepted");
+
+    process.evolve(1000., true, true);
+    reference_process.evolve(1000., true, true);
+    check(process.get_transmission_tree() == reference_process.get_transmission_tree(),
+            "schedule_rates: a rejected change altered the process");
+}
+
+//an invalid state file is rejected and leaves the process unchanged
+static void test_invalid_snapshot(const EdgeList& edge_list)
+{
+    vector<double> infection_rate = make_infection_rate(edge_list, 1.);
+    ContinuousSIR process(edge_list, 1., infection_rate);
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    process.evolve(1., true, true);
+    stringstream stream;
+    process.save_state(stream, true, false);
+    const string state = stream.str();
+
+    ContinuousSIR loaded_process(edge_list, 1., infection_rate);
+    loaded_process.seed(7);
+    loaded_process.infect_node_set({50});
+    ContinuousSIR reference_process(loaded_process);
+    auto rejected = [&](const string& corrupted_state)
+        {
+            istringstream corrupted_stream(corrupted_state);
+            return throws<runtime_error>([&]() {loaded_process.load_state(corrupted_stream);});
+        };
+
+    check(rejected(state.substr(0, state.size() - 1)), "load_state: truncated stream accepted");
+
+    string corrupted_state = state;
+    corrupted_state[8] = 2;
+    check(rejected(corrupted_state), "load_state: other version accepted");
+
+    //the node states follow the header, the network summary, the times
+    //and the RNG
+    size_t offset = 8 + 4 + 8 + string("ContinuousSIR").size() + 1 + 8 + 8 + 8 + 8;
+    uint64_t rng_size;
+    memcpy(&rng_size, state.data() + offset, sizeof(rng_size));
+    offset += 8 + rng_size + 8;
+    corrupted_state = state;
+    corrupted_state[offset] = 100;
+    check(rejected(corrupted_state), "load_state: invalid node state accepted");
+
+    loaded_process.evolve(1000., true, true);
+    reference_process.evolve(1000., true, true);
+    check(loaded_process.get_transmission_tree() == reference_process.get_transmission_tree(),
+            "load_state: a rejected state file altered the process");
+}
+
+//the quasi-stationary method never reaches extinction, so the period must
+//be finite
+static void test_quasistationary_period(const EdgeList& edge_list)
+{
+    ContinuousSIS process(edge_list, 1., make_infection_rate(edge_list, 1.));
+    process.seed(42);
+    process.infect_node_set({0, 100, 200});
+    process.set_quasistationary(10);
+    check(throws<invalid_argument>([&]() {process.evolve(INFINITY, false, false);}),
+            "ContinuousSIS: infinite period accepted with the quasi-stationary method");
+    check(throws<invalid_argument>([&]() {process.evolve_forks(2, INFINITY, 7);}),
+            "ContinuousSIS: infinite period accepted by evolve_forks");
+    process.evolve(10., false, false);
+    check(process.get_current_time() == 10., "ContinuousSIS: finite period failed");
+}
+
+
+int main()
+{
+    EdgeList edge_list = make_edge_list(300, 300, 1);
+    test_continuous_snapshot(edge_list);
+    test_discrete_snapshot(edge_list);
+    test_next_reaction_snapshot(edge_list);
+    test_annealed_snapshot();
+    test_forks(edge_list);
+    test_schedule(edge_list);
+    test_invalid_rates(edge_list);
+    test_invalid_snapshot(edge_list);
+    test_quasistationary_period(edge_list);
+    return report();
+}
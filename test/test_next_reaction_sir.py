@@ -0,0 +1,25 @@
+from fastsir import NextReactionSIR as sir
+import numpy as np
+import networkx as nx
+
+#Network parameters
+N = 1000
+mean_degree = 10
+p = mean_degree/(N-1)
+G = nx.erdos_renyi_graph(N,p)
+max_degree = np.max([G.degree(n) for n in G])
+edgelist = list(G.edges())
+
+#contagion parameters
+recovery_rate = 1
+infection_func = lambda beta,k: beta*k
+beta = 0.2
+
+#test
+infection_rate = infection_func(beta,np.arange(max_degree+1))
+process = sir(edgelist,recovery_rate,infection_rate)
+initial_infected_nodes = {np.random.randint(N)}
+process.infect_node_set(initial_infected_nodes)
+
+process.evolve(2)
+process.get_current_macro_state()
@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Guillaume St-Onge
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//tests of tau-leaping: the final size of epidemics with leaps must agree
+//with exact simulations
+//
+//usage: test_tau_leaping (returns 1 if a check fails)
+
+#include "ContinuousSIR.hpp"
+#include "TestUtilities.hpp"
+#include <cmath>
+#include <string>
+
+using namespace std;
+using namespace fastsir;
+
+//mean and standard error of the final number of recovered nodes
+static pair<double,double> final_size(ContinuousSIR process, size_t number_of_samples,
+        unsigned int seed)
+{
+    process.seed(seed);
+    double sum = 0.;
+    double sum_of_squares = 0.;
+    for (size_t sample = 0; sample < number_of_samples; sample++)
+    {
+        process.reset();
+        process.infect_fraction(0.01);
+        process.evolve(INFINITY, false, false);
+        double number_of_recovered = process.get_number_of_recovered_nodes();
+        sum += number_of_recovered;
+        sum_of_squares += number_of_recovered*number_of_recovered;
+    }
+    double mean = sum/number_of_samples;
+    double variance = sum_of_squares/number_of_samples - mean*mean;
+    return make_pair(mean, sqrt(variance/number_of_samples));
+}
+
+static void test_final_size(const EdgeList& edge_list, double transmission_rate)
+{
+    ContinuousSIR process(edge_list, 1., make_infection_rate(edge_list,
+                transmission_rate));
+    pair<double,double> exact = final_size(process, 200, 1);
+    process.set_tau_leaping(0.02, 50);
+    pair<double,double> leaping = final_size(process, 200, 2);
+
+    //the difference must be within the statistical error
+    double error = 4*sqrt(exact.second*exact.second + leaping.second*leaping.second);
+    cout << "transmission rate " << transmission_rate << ": exact "
+         << exact.first << ", leaping " << leaping.first << " (+/- " << error
+         << ")" << endl;
+    check(abs(exact.first - leaping.first) < error,
+            "final sizes differ with tau-leaping for the transmission rate "
+            + to_string(transmission_rate));
+}
+
+
+int main()
+{
+    EdgeList edge_list = make_edge_list(5000, 5000, 1);
+    test_final_size(edge_list, 0.3);
+    test_final_size(edge_list, 1.);
+    return report();
+}